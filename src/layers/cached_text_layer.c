@@ -0,0 +1,200 @@
+#include "cached_text_layer.h"
+
+typedef struct {
+  const char *text;
+  GFont font;
+  GColor text_color;
+  GColor background_color;
+  GTextAlignment alignment;
+
+  // Same size as the layer and in the frame buffer's pixel format
+  GBitmap *bitmap;
+  bool cache_is_valid;
+  uint32_t render_count;
+
+  // Columns of the frame buffer visible in every row of the layer at visible_range_y, learnt from
+  // the first capture there. A round display shows less of the rows further from its centre
+  bool visible_range_is_known;
+  int16_t visible_range_y;
+  int16_t visible_min_x;
+  int16_t visible_max_x;
+} CachedTextLayerData;
+
+static void invalidate_cache(CachedTextLayer *cached_text_layer) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  data->cache_is_valid = false;
+  layer_mark_dirty(cached_text_layer);
+}
+
+#ifdef PBL_BW
+static bool get_pixel_1bit(const uint8_t *row, int16_t x) {
+  return (row[x / 8] >> (x % 8)) & 1;
+}
+
+static void set_pixel_1bit(uint8_t *row, int16_t x, bool is_set) {
+  if (is_set) {
+    row[x / 8] |= (1 << (x % 8));
+  } else {
+    row[x / 8] &= ~(1 << (x % 8));
+  }
+}
+#endif
+
+// False if part of frame is known to be off screen, without capturing the frame buffer. The rows
+// the frame covers must be within the parent, which is the whole screen, and the columns within
+// the visible range if it has been learnt for those rows
+static bool frame_may_be_on_screen(CachedTextLayer *cached_text_layer, GRect frame) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  Layer *parent = layer_get_parent(cached_text_layer);
+  if (!parent) {
+    return false;
+  }
+
+  const GSize screen_size = layer_get_bounds(parent).size;
+  if (frame.origin.x < 0 || frame.origin.y < 0 || frame.origin.x + frame.size.w > screen_size.w ||
+      frame.origin.y + frame.size.h > screen_size.h) {
+    return false;
+  }
+  if (data->visible_range_is_known && data->visible_range_y == frame.origin.y) {
+    return frame.origin.x >= data->visible_min_x && frame.origin.x + frame.size.w - 1 <= data->visible_max_x;
+  }
+  return true;
+}
+
+// Learns the columns visible in every row of frame, which must be within the frame buffer's rows
+static void update_visible_range(CachedTextLayerData *data, GBitmap *frame_buffer, GRect frame) {
+  data->visible_min_x = 0;
+  data->visible_max_x = gbitmap_get_bounds(frame_buffer).size.w - 1;
+  for (int16_t y = 0; y < frame.size.h; y++) {
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, frame.origin.y + y);
+    if (info.min_x > data->visible_min_x) {
+      data->visible_min_x = info.min_x;
+    }
+    if (info.max_x < data->visible_max_x) {
+      data->visible_max_x = info.max_x;
+    }
+  }
+  data->visible_range_y = frame.origin.y;
+  data->visible_range_is_known = true;
+}
+
+// Copies the frame buffer pixels under frame into the bitmap, frame must be on screen
+static void copy_from_frame_buffer(CachedTextLayerData *data, GBitmap *frame_buffer, GRect frame) {
+  uint8_t *bitmap_data = gbitmap_get_data(data->bitmap);
+  const uint16_t bitmap_bytes_per_row = gbitmap_get_bytes_per_row(data->bitmap);
+
+  for (int16_t y = 0; y < frame.size.h; y++) {
+    uint8_t *bitmap_row = bitmap_data + (y * bitmap_bytes_per_row);
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, frame.origin.y + y);
+
+    for (int16_t x = 0; x < frame.size.w; x++) {
+#ifdef PBL_BW
+      set_pixel_1bit(bitmap_row, x, get_pixel_1bit(info.data, frame.origin.x + x));
+#else
+      bitmap_row[x] = info.data[frame.origin.x + x];
+#endif
+    }
+  }
+}
+
+static void cached_text_layer_update_proc(CachedTextLayer *cached_text_layer, GContext *ctx) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  GRect bounds = layer_get_bounds(cached_text_layer);
+
+  if (data->cache_is_valid) {
+    graphics_draw_bitmap_in_rect(ctx, data->bitmap, bounds);
+    return;
+  }
+
+  // Draw the text properly this once, then keep what it looked like
+  graphics_context_set_fill_color(ctx, data->background_color);
+  graphics_fill_rect(ctx, bounds, 0, GCornerNone);
+  if (data->text) {
+    graphics_context_set_text_color(ctx, data->text_color);
+    graphics_draw_text(ctx, data->text, data->font, bounds, GTextOverflowModeWordWrap,
+                       data->alignment, NULL);
+  }
+  data->render_count++;
+
+  // Part of the text is missing from the frame buffer while the layer hangs off the screen, so
+  // the cache is only taken once it is fully on screen. Until then it is drawn like this each frame,
+  // and the frame buffer is left alone
+  GRect frame = layer_get_frame(cached_text_layer);
+  if (!data->bitmap || !frame_may_be_on_screen(cached_text_layer, frame)) {
+    return;
+  }
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (frame_buffer) {
+    if (!data->visible_range_is_known || data->visible_range_y != frame.origin.y) {
+      update_visible_range(data, frame_buffer, frame);
+    }
+    if (frame_may_be_on_screen(cached_text_layer, frame)) {
+      copy_from_frame_buffer(data, frame_buffer, frame);
+      data->cache_is_valid = true;
+    }
+    graphics_release_frame_buffer(ctx, frame_buffer);
+  }
+}
+
+CachedTextLayer* cached_text_layer_create(GRect frame) {
+  CachedTextLayer *cached_text_layer = layer_create_with_data(frame, sizeof(CachedTextLayerData));
+  layer_set_update_proc(cached_text_layer, cached_text_layer_update_proc);
+
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  data->text = NULL;
+  data->font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  data->text_color = GColorBlack;
+  data->background_color = GColorWhite;
+  data->alignment = GTextAlignmentLeft;
+  data->bitmap = gbitmap_create_blank(frame.size, PBL_IF_BW_ELSE(GBitmapFormat1Bit, GBitmapFormat8Bit));
+  data->cache_is_valid = false;
+  data->render_count = 0;
+  data->visible_range_is_known = false;
+
+  return cached_text_layer;
+}
+
+void cached_text_layer_destroy(CachedTextLayer *cached_text_layer) {
+  if (cached_text_layer) {
+    CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+    if (data->bitmap) {
+      gbitmap_destroy(data->bitmap);
+    }
+    layer_destroy(cached_text_layer);
+  }
+}
+
+void cached_text_layer_set_text(CachedTextLayer *cached_text_layer, const char *text) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  data->text = text;
+  invalidate_cache(cached_text_layer);
+}
+
+void cached_text_layer_set_font(CachedTextLayer *cached_text_layer, GFont font) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  data->font = font;
+  invalidate_cache(cached_text_layer);
+}
+
+void cached_text_layer_set_text_color(CachedTextLayer *cached_text_layer, GColor color) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  data->text_color = color;
+  invalidate_cache(cached_text_layer);
+}
+
+void cached_text_layer_set_background_color(CachedTextLayer *cached_text_layer, GColor color) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  data->background_color = color;
+  invalidate_cache(cached_text_layer);
+}
+
+void cached_text_layer_set_text_alignment(CachedTextLayer *cached_text_layer, GTextAlignment alignment) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  data->alignment = alignment;
+  invalidate_cache(cached_text_layer);
+}
+
+uint32_t cached_text_layer_get_render_count(CachedTextLayer *cached_text_layer) {
+  CachedTextLayerData *data = (CachedTextLayerData *)layer_get_data(cached_text_layer);
+  return data->render_count;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <pebble.h>
+
+// Draws a line of text that is expected to move around, for example with TextChangeAnimation. The
+// text is laid out once when it changes and copied out of the frame buffer into a bitmap; every
+// frame after that is a single bitmap blit at the layer's current position.
+// The copy is taken from the frame buffer at the layer's frame, so the layer must be a direct
+// child of a full screen window's root layer, and it paints its background colour rather than
+// being transparent. The copy is only taken while the whole frame is on screen: text changed
+// while the layer hangs off an edge is drawn normally each frame until it is back on screen. On a
+// round display that means inside the visible part of every row the layer covers, so keep the
+// frame, and wherever it is moved to, clear of the curved edge or the cache is never used.
+
+typedef Layer CachedTextLayer;
+
+CachedTextLayer* cached_text_layer_create(GRect frame);
+// Also frees the cached bitmap
+void cached_text_layer_destroy(CachedTextLayer *cached_text_layer);
+
+// As with TextLayer the string is not copied, it must stay valid while it is being shown
+void cached_text_layer_set_text(CachedTextLayer *cached_text_layer, const char *text);
+void cached_text_layer_set_font(CachedTextLayer *cached_text_layer, GFont font);
+void cached_text_layer_set_text_color(CachedTextLayer *cached_text_layer, GColor color);
+void cached_text_layer_set_background_color(CachedTextLayer *cached_text_layer, GColor color);
+void cached_text_layer_set_text_alignment(CachedTextLayer *cached_text_layer, GTextAlignment alignment);
+
+// Number of times the text has been laid out and drawn rather than blitted from the cache
+uint32_t cached_text_layer_get_render_count(CachedTextLayer *cached_text_layer);
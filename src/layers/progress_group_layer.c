@@ -0,0 +1,124 @@
+#include "progress_group_layer.h"
+
+#define MIN(a,b) (((a)<(b))?(a):(b))
+
+#define BAR_SPACING_PX 4
+
+typedef struct {
+  uint16_t num_bars;
+  // Shared by every bar and worked out once when the layer is created
+  int16_t bar_width_px;
+  int16_t bar_height_px;
+  int16_t corner_radius;
+  GColor foreground_color;
+  GColor background_color;
+  int16_t progress_percent[];
+} ProgressGroupLayerData;
+
+static int16_t scale_progress_bar_width_px(unsigned int progress_percent, int16_t rect_width_px) {
+  return ((progress_percent * (rect_width_px)) / 100);
+}
+
+// Returns true if the bar is now a different width on screen
+static bool set_progress_percent(ProgressGroupLayerData *data, uint16_t index, int16_t progress_percent) {
+  progress_percent = MIN(100, progress_percent);
+  int16_t old_width_px = scale_progress_bar_width_px(data->progress_percent[index], data->bar_width_px);
+  data->progress_percent[index] = progress_percent;
+  return scale_progress_bar_width_px(progress_percent, data->bar_width_px) != old_width_px;
+}
+
+static void progress_group_layer_update_proc(ProgressGroupLayer* progress_group_layer, GContext* ctx) {
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  GRect bar = GRect(0, 0, data->bar_width_px, data->bar_height_px);
+
+  for (uint16_t i = 0; i < data->num_bars; i++) {
+    graphics_context_set_fill_color(ctx, data->background_color);
+    graphics_fill_rect(ctx, bar, data->corner_radius, GCornersAll);
+
+    GRect progress_bar = bar;
+    progress_bar.size.w = scale_progress_bar_width_px(data->progress_percent[i], data->bar_width_px);
+    graphics_context_set_fill_color(ctx, data->foreground_color);
+    graphics_fill_rect(ctx, progress_bar, data->corner_radius, GCornersAll);
+
+#ifdef PBL_PLATFORM_APLITE
+    graphics_context_set_stroke_color(ctx, data->background_color);
+    graphics_draw_rect(ctx, progress_bar);
+#endif
+
+    bar.origin.y += data->bar_height_px + BAR_SPACING_PX;
+  }
+}
+
+ProgressGroupLayer* progress_group_layer_create(GRect frame, uint16_t num_bars) {
+  ProgressGroupLayer *progress_group_layer = layer_create_with_data(frame,
+    sizeof(ProgressGroupLayerData) + num_bars * sizeof(int16_t));
+  layer_set_update_proc(progress_group_layer, progress_group_layer_update_proc);
+  layer_mark_dirty(progress_group_layer);
+
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  data->num_bars = num_bars;
+  data->bar_width_px = frame.size.w;
+  data->bar_height_px = num_bars ? (frame.size.h - (num_bars - 1) * BAR_SPACING_PX) / num_bars : 0;
+  data->corner_radius = 1;
+  data->foreground_color = GColorBlack;
+  data->background_color = GColorWhite;
+  for (uint16_t i = 0; i < num_bars; i++) {
+    data->progress_percent[i] = 0;
+  }
+
+  return progress_group_layer;
+}
+
+void progress_group_layer_destroy(ProgressGroupLayer* progress_group_layer) {
+  if (progress_group_layer) {
+    layer_destroy(progress_group_layer);
+  }
+}
+
+void progress_group_layer_set_progress(ProgressGroupLayer* progress_group_layer, uint16_t index,
+                                       int16_t progress_percent) {
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  if (index >= data->num_bars) {
+    return;
+  }
+  if (set_progress_percent(data, index, progress_percent)) {
+    layer_mark_dirty(progress_group_layer);
+  }
+}
+
+void progress_group_layer_set_many(ProgressGroupLayer* progress_group_layer, const int16_t *values,
+                                   uint16_t num_values) {
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  bool changed = false;
+  num_values = MIN(num_values, data->num_bars);
+  for (uint16_t i = 0; i < num_values; i++) {
+    // Not short-circuited, every bar gets its new value
+    changed |= set_progress_percent(data, i, values[i]);
+  }
+  if (changed) {
+    layer_mark_dirty(progress_group_layer);
+  }
+}
+
+void progress_group_layer_set_corner_radius(ProgressGroupLayer* progress_group_layer, uint16_t corner_radius) {
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  data->corner_radius = corner_radius;
+  layer_mark_dirty(progress_group_layer);
+}
+
+void progress_group_layer_set_foreground_color(ProgressGroupLayer* progress_group_layer, GColor color) {
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  data->foreground_color = color;
+  layer_mark_dirty(progress_group_layer);
+}
+
+void progress_group_layer_set_background_color(ProgressGroupLayer* progress_group_layer, GColor color) {
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  data->background_color = color;
+  layer_mark_dirty(progress_group_layer);
+}
+
+uint16_t progress_group_layer_get_num_bars(ProgressGroupLayer* progress_group_layer) {
+  ProgressGroupLayerData *data = (ProgressGroupLayerData *)layer_get_data(progress_group_layer);
+  return data->num_bars;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <pebble.h>
+
+typedef Layer ProgressGroupLayer;
+
+// Stacks num_bars progress bars of equal height inside the frame, all drawn by the one layer
+ProgressGroupLayer* progress_group_layer_create(GRect frame, uint16_t num_bars);
+void progress_group_layer_destroy(ProgressGroupLayer* progress_group_layer);
+void progress_group_layer_set_progress(ProgressGroupLayer* progress_group_layer, uint16_t index,
+                                       int16_t progress_percent);
+// Sets the first num_values bars from values[], with at most one redraw however many change
+void progress_group_layer_set_many(ProgressGroupLayer* progress_group_layer, const int16_t *values,
+                                   uint16_t num_values);
+void progress_group_layer_set_corner_radius(ProgressGroupLayer* progress_group_layer, uint16_t corner_radius);
+void progress_group_layer_set_foreground_color(ProgressGroupLayer* progress_group_layer, GColor color);
+void progress_group_layer_set_background_color(ProgressGroupLayer* progress_group_layer, GColor color);
+uint16_t progress_group_layer_get_num_bars(ProgressGroupLayer* progress_group_layer);
@@ -1,24 +1,165 @@
 #include "progress_layer.h"
+#include "../modules/easing.h"
+#include "../modules/frame_scheduler.h"
+#include "../modules/time_util.h"
 
 #define MIN(a,b) (((a)<(b))?(a):(b))
+#define MAX(a,b) (((a)>(b))?(a):(b))
+
+#define MARQUEE_DURATION_MS 1200
+// The sliding segment is a quarter of the width of the bar
+#define MARQUEE_WIDTH_DIVISOR 4
+
+// The ring is drawn as straight segments between points on the circle, each segment covering
+// 6 degrees. The ring only needs redrawing when the number of filled segments changes
+#define RADIAL_SEGMENTS 60
+#define RADIAL_SEGMENTS_PER_QUADRANT (RADIAL_SEGMENTS / 4)
+#define RADIAL_RING_WIDTH_PX 8
+#define RADIAL_TRIG_SHIFT 12
+
+// sin() of each segment boundary in the first quadrant, scaled by 1 << RADIAL_TRIG_SHIFT. The
+// other quadrants and cos() come from symmetry, so no trig is done while drawing
+static const int16_t s_radial_sin[RADIAL_SEGMENTS_PER_QUADRANT + 1] = {
+  0, 428, 852, 1266, 1666, 2048, 2408, 2741, 3044, 3314, 3547, 3742, 3896, 4006, 4074, 4096
+};
 
 typedef struct {
+  ProgressLayerStyle style;
   int16_t progress_percent;
+  // Width of the bar (or filled segments of the ring) as of the last redraw request, used to skip
+  // updates that change no pixels
+  int16_t marked_width_px;
+  uint32_t redraws_avoided;
   int16_t corner_radius;
   GColor foreground_color;
   GColor background_color;
+
+  // Indeterminate mode. A frame scheduler tick loops the segment until the mode is switched off
+  bool marquee_is_running;
+  uint32_t marquee_start_ms;
+  AnimationProgress marquee_progress;
+  // Set up once when the layer is created
+  int16_t marquee_width_px;
+  int16_t marquee_travel_px;
 } ProgressLayerData;
 
 static int16_t scale_progress_bar_width_px(unsigned int progress_percent, int16_t rect_width_px) {
   return ((progress_percent * (rect_width_px)) / 100);
 }
 
+static void mark_dirty_if_width_changed(ProgressLayer* progress_layer) {
+  ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
+  int16_t width_px = scale_progress_bar_width_px(data->progress_percent,
+                                                 progress_layer_get_resolution(progress_layer));
+
+  if (width_px == data->marked_width_px) {
+    data->redraws_avoided++;
+    return;
+  }
+  data->marked_width_px = width_px;
+  layer_mark_dirty(progress_layer);
+}
+
+// The segment enters from the left and leaves on the right. It is clipped to the bar rather than
+// wrapped around, so a frame never needs more than the background and one segment
+static GRect get_marquee_rect(ProgressLayerData *data, GRect bounds) {
+  int16_t x = ((data->marquee_travel_px * data->marquee_progress) >> 16) - data->marquee_width_px;
+  int16_t left = MAX(x, 0);
+  int16_t right = MIN(x + data->marquee_width_px, bounds.size.w);
+  return GRect(bounds.origin.x + left, bounds.origin.y, MAX(right - left, 0), bounds.size.h);
+}
+
+// Runs every frame while the marquee is on. The scheduler spaces frames further apart in low power
+// mode, and as the segment's position comes from the time it keeps the same speed with fewer frames
+static void marquee_tick(void *context) {
+  ProgressLayer *progress_layer = (ProgressLayer *)context;
+  ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
+  const uint32_t elapsed_ms = (time_util_get_ms() - data->marquee_start_ms) % MARQUEE_DURATION_MS;
+  data->marquee_progress = easing_apply(EasingCurveEaseInOut,
+                                        (elapsed_ms * ANIMATION_NORMALIZED_MAX) / MARQUEE_DURATION_MS);
+  layer_mark_dirty(progress_layer);
+
+  if (!frame_scheduler_schedule(marquee_tick, progress_layer, FRAME_SCHEDULER_FRAME_MS)) {
+    // With no frames to come, go back to showing the percent rather than a frozen segment
+    data->marquee_is_running = false;
+  }
+}
+
+// Point on the ring at the start of the given segment, counting clockwise from the top
+static GPoint get_radial_point(GPoint center, int16_t radius, int segment) {
+  segment %= RADIAL_SEGMENTS;
+  int quadrant = segment / RADIAL_SEGMENTS_PER_QUADRANT;
+  int step = segment % RADIAL_SEGMENTS_PER_QUADRANT;
+  int32_t sin_a = s_radial_sin[step];
+  int32_t cos_a = s_radial_sin[RADIAL_SEGMENTS_PER_QUADRANT - step];
+  int32_t x, y;
+  switch (quadrant) {
+    case 0: x = sin_a; y = -cos_a; break;
+    case 1: x = cos_a; y = sin_a; break;
+    case 2: x = -sin_a; y = cos_a; break;
+    default: x = -cos_a; y = -sin_a; break;
+  }
+  return GPoint(center.x + ((radius * x) >> RADIAL_TRIG_SHIFT),
+                center.y + ((radius * y) >> RADIAL_TRIG_SHIFT));
+}
+
+static void draw_radial_arc(GContext *ctx, GPoint center, int16_t radius, int first_segment,
+                            int num_segments) {
+  GPoint from = get_radial_point(center, radius, first_segment);
+  for (int i = 1; i <= num_segments; i++) {
+    GPoint to = get_radial_point(center, radius, first_segment + i);
+    graphics_draw_line(ctx, from, to);
+    from = to;
+  }
+}
+
+static void draw_radial_style(ProgressLayerData *data, GContext* ctx, GRect bounds) {
+  GPoint center = grect_center_point(&bounds);
+  int16_t radius = (MIN(bounds.size.w, bounds.size.h) - RADIAL_RING_WIDTH_PX) / 2;
+  graphics_context_set_stroke_width(ctx, RADIAL_RING_WIDTH_PX);
+
+  graphics_context_set_stroke_color(ctx, data->background_color);
+  draw_radial_arc(ctx, center, radius, 0, RADIAL_SEGMENTS);
+
+  graphics_context_set_stroke_color(ctx, data->foreground_color);
+  if (data->marquee_is_running) {
+    // A quarter of the ring chases round the circle
+    int first_segment = (RADIAL_SEGMENTS * data->marquee_progress) >> 16;
+    draw_radial_arc(ctx, center, radius, first_segment, RADIAL_SEGMENTS / MARQUEE_WIDTH_DIVISOR);
+  } else {
+    draw_radial_arc(ctx, center, radius, 0,
+                    scale_progress_bar_width_px(data->progress_percent, RADIAL_SEGMENTS));
+  }
+}
+
+static void draw_line_style(ProgressLayerData *data, GContext* ctx, GRect progress_bar) {
+  if (progress_bar.size.w > 0) {
+    graphics_context_set_fill_color(ctx, data->foreground_color);
+    graphics_fill_rect(ctx, progress_bar, 0, GCornerNone);
+  }
+}
+
 static void progress_layer_update_proc(ProgressLayer* progress_layer, GContext* ctx) {
   ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
   GRect bounds = layer_get_bounds(progress_layer);
 
-  int16_t progress_bar_width_px = scale_progress_bar_width_px(data->progress_percent, bounds.size.w);
-  GRect progress_bar = GRect(bounds.origin.x, bounds.origin.y, progress_bar_width_px, bounds.size.h);
+  if (data->style == ProgressLayerStyleRadial) {
+    draw_radial_style(data, ctx, bounds);
+    return;
+  }
+
+  GRect progress_bar;
+  if (data->marquee_is_running) {
+    progress_bar = get_marquee_rect(data, bounds);
+  } else {
+    int16_t progress_bar_width_px = scale_progress_bar_width_px(data->progress_percent, bounds.size.w);
+    progress_bar = GRect(bounds.origin.x, bounds.origin.y, progress_bar_width_px, bounds.size.h);
+  }
+
+  if (data->style == ProgressLayerStyleLine) {
+    draw_line_style(data, ctx, progress_bar);
+    return;
+  }
 
   graphics_context_set_fill_color(ctx, data->background_color);
   graphics_fill_rect(ctx, bounds, data->corner_radius, GCornersAll);
@@ -38,16 +179,24 @@ ProgressLayer* progress_layer_create(GRect frame) {
   layer_mark_dirty(progress_layer);
 
   ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
+  data->style = ProgressLayerStyleBar;
   data->progress_percent = 0;
+  data->marked_width_px = 0;
+  data->redraws_avoided = 0;
   data->corner_radius = 1;
   data->foreground_color = GColorBlack;
   data->background_color = GColorWhite;
+  data->marquee_is_running = false;
+  data->marquee_progress = 0;
+  data->marquee_width_px = frame.size.w / MARQUEE_WIDTH_DIVISOR;
+  data->marquee_travel_px = frame.size.w + data->marquee_width_px;
 
   return progress_layer;
 }
 
 void progress_layer_destroy(ProgressLayer* progress_layer) {
   if (progress_layer) {
+    progress_layer_set_indeterminate(progress_layer, false);
     layer_destroy(progress_layer);
   }
 }
@@ -55,13 +204,13 @@ void progress_layer_destroy(ProgressLayer* progress_layer) {
 void progress_layer_increment_progress(ProgressLayer* progress_layer, int16_t progress) {
   ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
   data->progress_percent = MIN(100, data->progress_percent + progress);
-  layer_mark_dirty(progress_layer);
+  mark_dirty_if_width_changed(progress_layer);
 }
 
 void progress_layer_set_progress(ProgressLayer* progress_layer, int16_t progress_percent) {
   ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
   data->progress_percent = MIN(100, progress_percent);
-  layer_mark_dirty(progress_layer);
+  mark_dirty_if_width_changed(progress_layer);
 }
 
 void progress_layer_set_corner_radius(ProgressLayer* progress_layer, uint16_t corner_radius) {
@@ -81,3 +230,39 @@ void progress_layer_set_background_color(ProgressLayer* progress_layer, GColor c
   data->background_color = color;
   layer_mark_dirty(progress_layer);
 }
+
+void progress_layer_set_style(ProgressLayer* progress_layer, ProgressLayerStyle style) {
+  ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
+  data->style = style;
+  // The ring counts segments rather than pixels, so start tracking again in the new units
+  data->marked_width_px = -1;
+  mark_dirty_if_width_changed(progress_layer);
+}
+
+void progress_layer_set_indeterminate(ProgressLayer* progress_layer, bool indeterminate) {
+  ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
+
+  if (indeterminate && !data->marquee_is_running) {
+    data->marquee_is_running = true;
+    data->marquee_start_ms = time_util_get_ms();
+    data->marquee_progress = 0;
+    marquee_tick(progress_layer);
+  } else if (!indeterminate && data->marquee_is_running) {
+    frame_scheduler_cancel(marquee_tick, progress_layer);
+    data->marquee_is_running = false;
+  }
+
+  // The bar will be drawn from scratch, whatever the last determinate width was
+  data->marked_width_px = -1;
+  layer_mark_dirty(progress_layer);
+}
+
+int16_t progress_layer_get_resolution(ProgressLayer* progress_layer) {
+  ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
+  return (data->style == ProgressLayerStyleRadial) ? RADIAL_SEGMENTS : layer_get_bounds(progress_layer).size.w;
+}
+
+uint32_t progress_layer_get_redraws_avoided(ProgressLayer* progress_layer) {
+  ProgressLayerData *data = (ProgressLayerData *)layer_get_data(progress_layer);
+  return data->redraws_avoided;
+}
@@ -4,10 +4,28 @@
 
 typedef Layer ProgressLayer;
 
+typedef enum {
+  // Rounded bar drawn over a background track
+  ProgressLayerStyleBar,
+  // Thin line with no background, as used under a status bar
+  ProgressLayerStyleLine,
+  // Ring around the edge of the layer, filled clockwise from the top, for round displays
+  ProgressLayerStyleRadial,
+} ProgressLayerStyle;
+
 ProgressLayer* progress_layer_create(GRect frame);
 void progress_layer_destroy(ProgressLayer* progress_layer);
 void progress_layer_increment_progress(ProgressLayer* progress_layer, int16_t progress);
 void progress_layer_set_progress(ProgressLayer* progress_layer, int16_t progress_percent);
 void progress_layer_set_corner_radius(ProgressLayer* progress_layer, uint16_t corner_radius);
 void progress_layer_set_foreground_color(ProgressLayer* progress_layer, GColor color);
-void progress_layer_set_background_color(ProgressLayer* progress_layer, GColor color);
\ No newline at end of file
+void progress_layer_set_background_color(ProgressLayer* progress_layer, GColor color);
+void progress_layer_set_style(ProgressLayer* progress_layer, ProgressLayerStyle style);
+// Shows a segment sliding along the bar for operations of unknown length, the percent progress is
+// kept and shown again when indeterminate mode is switched off
+void progress_layer_set_indeterminate(ProgressLayer* progress_layer, bool indeterminate);
+// Number of steps the progress is drawn in: pixels of width for the bar and line styles, segments
+// for the radial style. A percent is shown as (percent * resolution) / 100 of them
+int16_t progress_layer_get_resolution(ProgressLayer* progress_layer);
+// Number of progress updates that were dropped because the bar would not have changed on screen
+uint32_t progress_layer_get_redraws_avoided(ProgressLayer* progress_layer);
\ No newline at end of file
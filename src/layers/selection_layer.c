@@ -2,6 +2,9 @@
 
 #include <pebble.h>
 #include "selection_layer.h"
+#include "../modules/easing.h"
+#include "../modules/power_policy.h"
+#include "../modules/time_util.h"
 
 // Look and feel
 #define DEFAULT_CELL_PADDING 10
@@ -9,8 +12,18 @@
 #define DEFAULT_FONT FONT_KEY_GOTHIC_28_BOLD
 #define DEFAULT_ACTIVE_COLOR GColorWhite
 #define DEFAULT_INACTIVE_COLOR PBL_IF_COLOR_ELSE(GColorDarkGray, GColorBlack)
+#define INVALID_CELL_INDEX -1
+#define FONT_METRICS_SAMPLE_TEXT "0"
+#define FONT_METRICS_SAMPLE_BOX_SIZE 200
 
 #define BUTTON_HOLD_REPEAT_MS 100
+// A hold is considered over when no repeat has arrived for this long
+#define BUTTON_HOLD_RELEASE_MS (2 * BUTTON_HOLD_REPEAT_MS)
+#define DEFAULT_REPEAT_ACCELERATION ((SelectionLayerRepeatAcceleration) { \
+  .initial_step = 1, \
+  .max_step = 1, \
+  .step_growth_interval_ms = 0, \
+})
 #define SETTLE_HEIGHT_DIFF 6
 
 // Animation
@@ -18,105 +31,310 @@
 #define BUMP_SETTLE_DURATION_MS 214
 #define SLIDE_DURATION_MS 107
 #define SLIDE_SETTLE_DURATION_MS 179
+// Drawing a frame should take no longer than this, see FrameWatchdog
+#define FRAME_BUDGET_MS 15
+
+// Animation progress is kept at full ANIMATION_NORMALIZED_MAX resolution. Scaling by it is a
+// multiply and a shift, ANIMATION_NORMALIZED_MAX + 1 being 1 << ANIMATION_PROGRESS_SHIFT
+#define ANIMATION_PROGRESS_SHIFT 16
+#define ANIMATION_PROGRESS_HALF (1 << (ANIMATION_PROGRESS_SHIFT - 1))
+// Phase progress per millisecond, pre-scaled by 1 << PHASE_RATE_SHIFT so that turning elapsed time
+// into progress needs no division at runtime
+#define PHASE_RATE_SHIFT 8
+#define PHASE_RATE(duration_ms) ((ANIMATION_NORMALIZED_MAX << PHASE_RATE_SHIFT) / (duration_ms))
 
 // Function prototypes
-static Animation* prv_create_bump_settle_animation(Layer *layer);
-static Animation* prv_create_slide_settle_animation(Layer *layer);
+static bool prv_process_input_queue(Layer *layer);
 
-static int prv_get_pixels_for_bump_settle(int anim_percent_complete) {
-  if (anim_percent_complete) {
-    return SETTLE_HEIGHT_DIFF - ((SETTLE_HEIGHT_DIFF * anim_percent_complete) / 100);
+// Returns value * progress / ANIMATION_NORMALIZED_MAX, rounded to the nearest pixel
+static int prv_scale_by_progress(int value, AnimationProgress progress) {
+  const int magnitude = (value < 0) ? -value : value;
+  const int scaled = ((magnitude * progress) + ANIMATION_PROGRESS_HALF) >> ANIMATION_PROGRESS_SHIFT;
+  return (value < 0) ? -scaled : scaled;
+}
+
+static int prv_get_pixels_for_bump_settle(AnimationProgress progress) {
+  if (progress) {
+    return SETTLE_HEIGHT_DIFF - prv_scale_by_progress(SETTLE_HEIGHT_DIFF, progress);
   } else {
     return 0;
   }
 }
 
-static int prv_get_font_top_padding(GFont font) {
-  if (font == fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD)) {
-    return 10;
-  } else if (font == fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD)) {
-    return 10;
+// Measures the font once so centring the text each frame is just a couple of integer operations
+static void prv_update_font_metrics(SelectionLayerData *data) {
+  // The system fonts used by the patterns have hand tuned metrics
+  if (data->font == fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD)) {
+    data->font_height = 18;
+    data->font_top_padding = 10;
+    data->font_metrics_are_valid = true;
+  } else if (data->font == fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD)) {
+    data->font_height = 14;
+    data->font_top_padding = 10;
+    data->font_metrics_are_valid = true;
   } else {
-    return 0;
+    // Anything else is measured from what it really draws, see prv_measure_font()
+    data->font_metrics_are_valid = false;
+  }
+}
+
+// Position of the layer's bounds on screen, which is where its pixels are in the frame buffer
+static GPoint prv_get_screen_origin(Layer *layer) {
+  GPoint origin = GPointZero;
+  for (; layer; layer = layer_get_parent(layer)) {
+    const GRect frame = layer_get_frame(layer);
+    const GRect bounds = layer_get_bounds(layer);
+    origin.x += frame.origin.x + bounds.origin.x;
+    origin.y += frame.origin.y + bounds.origin.y;
   }
+  return origin;
+}
+
+static uint8_t prv_get_frame_buffer_pixel(const GBitmapDataRowInfo *info, int16_t x) {
+#ifdef PBL_BW
+  return (info->data[x / 8] >> (x % 8)) & 1;
+#else
+  return info->data[x];
+#endif
+}
+
+static void prv_set_frame_buffer_pixel(const GBitmapDataRowInfo *info, int16_t x, uint8_t value) {
+#ifdef PBL_BW
+  info->data[x / 8] = (info->data[x / 8] & ~(1 << (x % 8))) | (value << (x % 8));
+#else
+  info->data[x] = value;
+#endif
 }
 
-static int prv_get_y_offset_which_vertically_centers_font(GFont font, int height) {
-  int font_height = 0;
-  int font_top_padding = prv_get_font_top_padding(font);
-  if (font == fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD)) {
-    font_height = 18;
-  } else if (font == fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD)) {
-    font_height = 14;
+// Copies the frame buffer pixels under rect to or from pixels, one byte per pixel. Returns false
+// without copying anything if part of rect is not on screen
+static bool prv_copy_frame_buffer_rect(GBitmap *frame_buffer, GRect rect, uint8_t *pixels,
+                                       bool to_frame_buffer) {
+  const int16_t frame_buffer_height = gbitmap_get_bounds(frame_buffer).size.h;
+  if (rect.origin.y < 0 || rect.origin.y + rect.size.h > frame_buffer_height) {
+    return false;
+  }
+
+  for (int16_t y = 0; y < rect.size.h; y++) {
+    const GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, rect.origin.y + y);
+    if (rect.origin.x < info.min_x || rect.origin.x + rect.size.w - 1 > info.max_x) {
+      return false;
+    }
+    for (int16_t x = 0; x < rect.size.w; x++) {
+      uint8_t *pixel = &pixels[(y * rect.size.w) + x];
+      if (to_frame_buffer) {
+        prv_set_frame_buffer_pixel(&info, rect.origin.x + x, *pixel);
+      } else {
+        *pixel = prv_get_frame_buffer_pixel(&info, rect.origin.x + x);
+      }
+    }
+  }
+  return true;
+}
+
+// Pebble fonts leave empty space above the glyphs, and how much varies from font to font. Draws
+// the sample digit in the corner of the layer and finds the rows it actually inked, then puts back
+// whatever was there. Returns false without measuring if the corner is not on screen.
+static bool prv_measure_glyphs(Layer *layer, GContext *ctx, GSize size, int *top, int *height) {
+  SelectionLayerData *data = layer_get_data(layer);
+  const GRect box = GRect(0, 0, size.w, size.h);
+  const GPoint screen_origin = prv_get_screen_origin(layer);
+  const GRect screen_box = GRect(screen_origin.x, screen_origin.y, size.w, size.h);
+  uint8_t *saved_pixels = malloc(size.w * size.h);
+  if (!saved_pixels) {
+    return false;
   }
 
-  return (height / 2) - (font_height / 2) - font_top_padding;
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  const bool is_on_screen = frame_buffer &&
+                            prv_copy_frame_buffer_rect(frame_buffer, screen_box, saved_pixels, false);
+  if (frame_buffer) {
+    graphics_release_frame_buffer(ctx, frame_buffer);
+  }
+  if (!is_on_screen) {
+    free(saved_pixels);
+    return false;
+  }
+
+  // Black on white, the layer's text is drawn in the context's default black
+  graphics_context_set_fill_color(ctx, GColorWhite);
+  graphics_fill_rect(ctx, box, 0, GCornerNone);
+  graphics_context_set_text_color(ctx, GColorBlack);
+  graphics_draw_text(ctx, FONT_METRICS_SAMPLE_TEXT, data->font, box, GTextOverflowModeFill,
+                     GTextAlignmentLeft, NULL);
+
+  frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    free(saved_pixels);
+    return false;
+  }
+  int16_t ink_top = -1;
+  int16_t ink_bottom = -1;
+  const uint8_t white = PBL_IF_BW_ELSE(1, GColorWhite.argb);
+  for (int16_t y = 0; y < size.h; y++) {
+    const GBitmapDataRowInfo info = gbitmap_get_data_row_info(frame_buffer, screen_box.origin.y + y);
+    for (int16_t x = 0; x < size.w; x++) {
+      if (prv_get_frame_buffer_pixel(&info, screen_box.origin.x + x) != white) {
+        if (ink_top < 0) {
+          ink_top = y;
+        }
+        ink_bottom = y + 1;
+        break;
+      }
+    }
+  }
+  prv_copy_frame_buffer_rect(frame_buffer, screen_box, saved_pixels, true);
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  free(saved_pixels);
+
+  if (ink_top < 0) {
+    // Nothing was drawn, so treat the whole line as glyph
+    ink_top = 0;
+    ink_bottom = size.h;
+  }
+  *top = ink_top;
+  *height = ink_bottom - ink_top;
+  return true;
+}
+
+// Measures a font without hand tuned metrics on the first draw after it is set. If the glyphs
+// can't be measured then, the text is centred by its whole line instead, which is close enough to
+// not be worth trying again every frame.
+static void prv_measure_font(Layer *layer, GContext *ctx) {
+  SelectionLayerData *data = layer_get_data(layer);
+  const GSize size = graphics_text_layout_get_content_size(FONT_METRICS_SAMPLE_TEXT, data->font,
+      GRect(0, 0, FONT_METRICS_SAMPLE_BOX_SIZE, FONT_METRICS_SAMPLE_BOX_SIZE),
+      GTextOverflowModeFill, GTextAlignmentLeft);
+
+  if (size.w <= 0 || size.h <= 0 ||
+      !prv_measure_glyphs(layer, ctx, size, &data->font_top_padding, &data->font_height)) {
+    data->font_top_padding = 0;
+    data->font_height = (size.h > 0) ? size.h : 0;
+  }
+  data->font_metrics_are_valid = true;
+}
+
+static int prv_get_y_offset_which_vertically_centers_font(SelectionLayerData *data, int height) {
+  return (height / 2) - (data->font_height / 2) - data->font_top_padding;
+}
+
+static void prv_invalidate_cell_text(SelectionLayerData *data, int idx) {
+  if (idx >= 0 && idx < data->num_cells) {
+    data->cells[idx].text_is_valid = false;
+  }
+}
+
+static void prv_invalidate_all_cell_text(SelectionLayerData *data) {
+  for (int i = 0; i < data->num_cells; i++) {
+    data->cells[i].text_is_valid = false;
+  }
+}
+
+static int prv_get_row(SelectionLayerData *data, int idx) {
+  return idx / data->num_columns;
+}
+
+// Lays the cells out in rows of num_columns, in reading order, and stores each cell's frame so
+// drawing and hit testing are table lookups. Cells in a row are separated by cell_padding, and so
+// are the rows, which share the height of the layer equally.
+static void prv_rebuild_cell_geometry(Layer *layer) {
+  SelectionLayerData *data = layer_get_data(layer);
+  if (data->num_cells == 0) {
+    return;
+  }
+
+  const int num_rows = prv_get_row(data, data->num_cells - 1) + 1;
+  const int row_height = (layer_get_bounds(layer).size.h - ((num_rows - 1) * data->cell_padding)) / num_rows;
+  for (int i = 0, current_x_offset = 0; i < data->num_cells; i++) {
+    if ((i % data->num_columns) == 0) {
+      current_x_offset = 0;
+    }
+
+    const int row = prv_get_row(data, i);
+    data->cells[i].frame = GRect(current_x_offset, row * (row_height + data->cell_padding),
+                                 data->cells[i].width, row_height);
+    current_x_offset += data->cells[i].width + data->cell_padding;
+  }
+}
+
+// Height of a cell, the selected one grows while the bump settles
+static int prv_get_cell_height(SelectionLayerData *data, int idx) {
+  int height = data->cells[idx].frame.size.h;
+  if (data->selected_cell_idx == idx) {
+    height += prv_get_pixels_for_bump_settle(data->bump_settle_anim_progress);
+  }
+  return height;
 }
 
 static void prv_draw_cell_backgrounds(Layer *layer, GContext *ctx) {
   SelectionLayerData *data = layer_get_data(layer);
   // Loop over each cell and draw the background rectangles
-  for (int i = 0, current_x_offset = 0; i < data->num_cells; i++) {
-    if (data->cell_widths[i] == 0) {
+  for (int i = 0; i < data->num_cells; i++) {
+    const GRect *frame = &data->cells[i].frame;
+    if (frame->size.w == 0) {
       continue;
     }
 
-    int y_offset = 0;
+    int y_offset = frame->origin.y;
     if (data->selected_cell_idx == i && data->bump_is_upwards) {
-      y_offset = -prv_get_pixels_for_bump_settle(data->bump_settle_anim_progress);
-    }
-
-    int height = layer_get_bounds(layer).size.h;
-    if (data->selected_cell_idx == i) {
-      height += prv_get_pixels_for_bump_settle(data->bump_settle_anim_progress);
+      y_offset -= prv_get_pixels_for_bump_settle(data->bump_settle_anim_progress);
     }
 
-    const GRect rect = GRect(current_x_offset, y_offset, data->cell_widths[i], height);
+    const GRect rect = GRect(frame->origin.x, y_offset, frame->size.w, prv_get_cell_height(data, i));
 
     GColor bg_color = data->inactive_background_color;
-
     if (data->selected_cell_idx == i && !data->slide_amin_progress) {
       bg_color = data->active_background_color;
     }
     graphics_context_set_fill_color(ctx, bg_color);
     graphics_fill_rect(ctx, rect, 1, GCornerNone);
-
-    current_x_offset += data->cell_widths[i] + data->cell_padding;
   }
 }
 
-static void prv_draw_slider_slide(Layer *layer, GContext *ctx) {
-  SelectionLayerData *data = layer_get_data(layer);
+// Moving between rows the selection wipes out of the end of one row and into the start of the
+// other, so it never cuts diagonally across the grid
+static void prv_draw_slider_row_change(SelectionLayerData *data, GContext *ctx, GRect from, GRect to) {
+  const AnimationProgress progress = data->slide_amin_progress;
+  const int left_px = prv_scale_by_progress(from.size.w, progress);
+  // Overshoot the next cell by the padding in the direction of travel
+  const int entered_px = prv_scale_by_progress(to.size.w + data->cell_padding, progress);
 
-  int starting_x_offset = 0;
-  for (int i = 0; i < data->num_cells; i++) {
-    if (data->selected_cell_idx == i) {
-      break;
-    }
-    starting_x_offset += data->cell_widths[i] + data->cell_padding;
+  GRect leaving = GRect(from.origin.x, from.origin.y, from.size.w - left_px, from.size.h);
+  GRect entering = GRect(to.origin.x, to.origin.y, entered_px, to.size.h);
+  if (data->slide_is_forward) {
+    leaving.origin.x += left_px;
+  } else {
+    entering.origin.x += to.size.w - entered_px;
   }
 
-  int next_cell_width = data->cell_widths[data->selected_cell_idx + 1];
-  if (!data->slide_is_forward) {
-    next_cell_width = data->cell_widths[data->selected_cell_idx - 1];
-  }
+  graphics_context_set_fill_color(ctx, data->active_background_color);
+  graphics_fill_rect(ctx, leaving, 1, GCornerNone);
+  graphics_fill_rect(ctx, entering, 1, GCornerNone);
+}
 
-  int slide_distance = next_cell_width + data->cell_padding;
-  int current_slide_distance = (slide_distance * data->slide_amin_progress) / 100;
-  if (!data->slide_is_forward) {
-    current_slide_distance = -current_slide_distance;
+static void prv_draw_slider_slide(Layer *layer, GContext *ctx) {
+  SelectionLayerData *data = layer_get_data(layer);
+
+  const int next_idx = data->selected_cell_idx + (data->slide_is_forward ? 1 : -1);
+  const GRect from = data->cells[data->selected_cell_idx].frame;
+  GRect to = data->cells[next_idx].frame;
+  if (data->slide_changes_row) {
+    prv_draw_slider_row_change(data, ctx, from, to);
+    return;
   }
 
-  int current_x_offset = starting_x_offset + current_slide_distance;
-  int cur_cell_width = data->cell_widths[data->selected_cell_idx];
-  int total_cell_width_change = next_cell_width - cur_cell_width + data->cell_padding;
-  int current_cell_width_change = (total_cell_width_change * (int) data->slide_amin_progress) / 100;
-  int current_cell_width = cur_cell_width + current_cell_width_change;
+  // Overshoot the next cell by the padding in the direction of travel
+  to.size.w += data->cell_padding;
   if (!data->slide_is_forward) {
-    current_x_offset -= current_cell_width_change;
+    to.origin.x -= data->cell_padding;
   }
 
-  GRect rect = GRect(current_x_offset, 0, current_cell_width, layer_get_bounds(layer).size.h);
+  const AnimationProgress progress = data->slide_amin_progress;
+  GRect rect = GRect(
+    from.origin.x + prv_scale_by_progress(to.origin.x - from.origin.x, progress),
+    from.origin.y,
+    from.size.w + prv_scale_by_progress(to.size.w - from.size.w, progress),
+    from.size.h);
 
   graphics_context_set_fill_color(ctx, data->active_background_color);
   graphics_fill_rect(ctx, rect, 1, GCornerNone);
@@ -124,65 +342,73 @@ static void prv_draw_slider_slide(Layer *layer, GContext *ctx) {
 
 static void prv_draw_slider_settle(Layer *layer, GContext *ctx) {
   SelectionLayerData *data = layer_get_data(layer);
-  int starting_x_offset = 0;
-  for (int i = 0; i < data->num_cells; i++) {
-    if (data->selected_cell_idx == i) {
-      break;
-    }
-    starting_x_offset += data->cell_widths[i] + data->cell_padding;
-  }
 
-  int x_offset = starting_x_offset;
-  if (data->slide_is_forward) {
-    x_offset += data->cell_widths[data->selected_cell_idx];
-  }
-
-  int current_width = (data->cell_padding * data->slide_settle_anim_progress) / 100;
-  if (!data->slide_is_forward) {
-    x_offset -= current_width;
-  }
-
-  GRect rect = GRect(x_offset, 0, current_width, layer_get_bounds(layer).size.h);
+  const GRect frame = data->cells[data->selected_cell_idx].frame;
+  const int overshoot = prv_scale_by_progress(data->cell_padding, data->slide_settle_anim_progress);
+  const int x_offset = data->slide_is_forward ? (frame.origin.x + frame.size.w) : (frame.origin.x - overshoot);
+  GRect rect = GRect(x_offset, frame.origin.y, overshoot, frame.size.h);
 
   graphics_context_set_fill_color(ctx, data->active_background_color);
   graphics_fill_rect(ctx, rect, 1, GCornerNone);
 }
 
+static char* prv_get_cell_text(SelectionLayerData *data, int idx) {
+  if (!data->cache_cell_text) {
+    return data->callbacks.get_cell_text(idx, data->context);
+  }
+
+  SelectionLayerCell *cell = &data->cells[idx];
+  if (!cell->text_is_valid) {
+    char *text = data->callbacks.get_cell_text(idx, data->context);
+    if (text) {
+      strncpy(cell->text, text, sizeof(cell->text) - 1);
+      cell->text[sizeof(cell->text) - 1] = '\0';
+    } else {
+      cell->text[0] = '\0';
+    }
+    cell->text_is_valid = true;
+  }
+  return cell->text[0] ? cell->text : NULL;
+}
+
 static void prv_draw_text(Layer *layer, GContext *ctx) {
   SelectionLayerData *data = layer_get_data(layer);
-  for (int i = 0, current_x_offset = 0; i < data->num_cells; i++) {
-    if (data->callbacks.get_cell_text) {
-      char *text = data->callbacks.get_cell_text(i, data->context);
-      if (text) {
-        int height = layer_get_bounds(layer).size.h;
-        if (data->selected_cell_idx == i) {
-          height += prv_get_pixels_for_bump_settle(data->bump_settle_anim_progress);
-        }
-        int y_offset = prv_get_y_offset_which_vertically_centers_font(data->font, height);
+  if (!data->callbacks.get_cell_text) {
+    return;
+  }
 
-        if (data->selected_cell_idx == i && data->bump_is_upwards) {
-          y_offset -= prv_get_pixels_for_bump_settle(data->bump_settle_anim_progress);
-        }
+  for (int i = 0; i < data->num_cells; i++) {
+    char *text = prv_get_cell_text(data, i);
+    if (!text) {
+      continue;
+    }
 
-        if (data->selected_cell_idx == i) {
-          int delta = (data->bump_text_anim_progress * prv_get_font_top_padding(data->font)) / 100;
-          if (data->bump_is_upwards) {
-            delta *= -1;
-          }
-          y_offset += delta;
-        }
+    const GRect *frame = &data->cells[i].frame;
+    const int height = prv_get_cell_height(data, i);
+    int y_offset = frame->origin.y + prv_get_y_offset_which_vertically_centers_font(data, height);
+    if (data->selected_cell_idx == i && data->bump_is_upwards) {
+      y_offset -= prv_get_pixels_for_bump_settle(data->bump_settle_anim_progress);
+    }
 
-        GRect rect = GRect(current_x_offset, y_offset, data->cell_widths[i], height);
-        graphics_draw_text(ctx, text, data->font, rect, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
+    if (data->selected_cell_idx == i) {
+      int delta = prv_scale_by_progress(data->font_top_padding, data->bump_text_anim_progress);
+      if (data->bump_is_upwards) {
+        delta *= -1;
       }
+      y_offset += delta;
     }
 
-    current_x_offset += data->cell_widths[i] + data->cell_padding;
+    const GRect rect = GRect(frame->origin.x, y_offset, frame->size.w, height);
+    graphics_draw_text(ctx, text, data->font, rect, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
   }
 }
 
 static void prv_draw_selection_layer(Layer *layer, GContext *ctx) {
   SelectionLayerData *data = layer_get_data(layer);
+  frame_watchdog_begin_frame(&data->watchdog);
+  if (!data->font_metrics_are_valid) {
+    prv_measure_font(layer, ctx);
+  }
   prv_draw_cell_backgrounds(layer, ctx);
 
   if (data->slide_amin_progress) {
@@ -193,112 +419,240 @@ static void prv_draw_selection_layer(Layer *layer, GContext *ctx) {
   }
 
   prv_draw_text(layer, ctx);
+  frame_watchdog_end_frame(&data->watchdog);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-//! Increment / Decrement Animation
-
-//! This animation causes a the active cell to "bump" when the user presses the up button.
-//! This animation has two parts:
-//! 1) The "text to cell edge"
-//! 2) The "background settle"
-
-//! The "text to cell edge" (bump_text) moves the text until it hits the top / bottom of the cell.
+//! Animation engine
+
+//! All of the animation phases below are driven by a single per-frame tick (the "engine") that runs
+//! on the shared frame scheduler, so the layer never allocates an Animation. A button press only
+//! resets the phase of a track and makes sure the tick is scheduled. The tick schedules itself for
+//! the next frame until every track is idle, and then stops until the next press.
+//! While a button is held the engine also applies the accumulated repeat steps once per frame, and
+//! only stops once the hold is over.
+//! Presses are not applied directly, they go through the input queue below.
+
+static const uint32_t s_phase_durations_ms[] = {
+  [SelectionLayerAnimationPhaseNone] = 0,
+  [SelectionLayerAnimationPhaseBumpText] = BUMP_TEXT_DURATION_MS,
+  [SelectionLayerAnimationPhaseBumpSettle] = BUMP_SETTLE_DURATION_MS,
+  [SelectionLayerAnimationPhaseSlide] = SLIDE_DURATION_MS,
+  [SelectionLayerAnimationPhaseSlideSettle] = SLIDE_SETTLE_DURATION_MS,
+};
+
+static const uint32_t s_phase_rates[] = {
+  [SelectionLayerAnimationPhaseNone] = 0,
+  [SelectionLayerAnimationPhaseBumpText] = PHASE_RATE(BUMP_TEXT_DURATION_MS),
+  [SelectionLayerAnimationPhaseBumpSettle] = PHASE_RATE(BUMP_SETTLE_DURATION_MS),
+  [SelectionLayerAnimationPhaseSlide] = PHASE_RATE(SLIDE_DURATION_MS),
+  [SelectionLayerAnimationPhaseSlideSettle] = PHASE_RATE(SLIDE_SETTLE_DURATION_MS),
+};
+
+static void prv_change_value(Layer *layer, bool is_upwards, uint16_t count) {
+  SelectionLayerData *data = layer_get_data(layer);
 
-//! The "background settle" (bump_settle) is a reaction to the "text to cell edge" animation.
-//! The top of the cell immediately expands down giving the impression that the text "pushed" the
-//! cell making it bigger. The cell then shrinks / settles back to its original height
-//! with the text vertically centered
+  if (is_upwards) {
+    data->callbacks.increment(data->selected_cell_idx, count, data->context);
+  } else {
+    data->callbacks.decrement(data->selected_cell_idx, count, data->context);
+  }
+  prv_invalidate_cell_text(data, data->selected_cell_idx);
+}
 
-static void prv_bump_text_impl(struct Animation *animation, const AnimationProgress distance_normalized) {
-  Layer *layer = (Layer*) animation_get_context(animation);
+static void prv_update_phase(Layer *layer, SelectionLayerAnimationPhase phase, AnimationProgress progress) {
   SelectionLayerData *data = layer_get_data(layer);
 
-  data->bump_text_anim_progress = (100 * distance_normalized) / ANIMATION_NORMALIZED_MAX;
-  layer_mark_dirty(layer);
+  switch (phase) {
+    case SelectionLayerAnimationPhaseBumpText:
+      data->bump_text_anim_progress = easing_apply(EasingCurveEaseIn, progress);
+      break;
+    case SelectionLayerAnimationPhaseBumpSettle:
+      data->bump_settle_anim_progress = easing_apply(EasingCurveEaseOut, progress);
+      break;
+    case SelectionLayerAnimationPhaseSlide:
+      data->slide_amin_progress = easing_apply(EasingCurveEaseIn, progress);
+      break;
+    case SelectionLayerAnimationPhaseSlideSettle:
+      data->slide_settle_anim_progress = ANIMATION_NORMALIZED_MAX - easing_apply(EasingCurveEaseOut, progress);
+      break;
+    default:
+      break;
+  }
 }
 
-static void prv_bump_text_stopped(Animation *animation, bool finished, void *context) {
-  Layer *layer = (Layer*)animation_get_context(animation);
+// Ends the current phase of a track, applying its side effects, and moves on to the next phase
+static void prv_finish_phase(Layer *layer, SelectionLayerAnimationTrack *track, uint32_t end_time_ms) {
   SelectionLayerData *data = layer_get_data(layer);
+  SelectionLayerAnimationPhase next_phase = SelectionLayerAnimationPhaseNone;
 
-  data->bump_text_anim_progress = 0;
+  switch (track->phase) {
+    case SelectionLayerAnimationPhaseBumpText:
+      data->bump_text_anim_progress = 0;
+      prv_change_value(layer, data->bump_is_upwards, 1);
+      next_phase = SelectionLayerAnimationPhaseBumpSettle;
+      break;
+    case SelectionLayerAnimationPhaseBumpSettle:
+      data->bump_settle_anim_progress = 0;
+      break;
+    case SelectionLayerAnimationPhaseSlide:
+      data->slide_amin_progress = 0;
+      if (data->slide_is_forward) {
+        data->selected_cell_idx++;
+      } else {
+        data->selected_cell_idx--;
+      }
+      next_phase = SelectionLayerAnimationPhaseSlideSettle;
+      break;
+    case SelectionLayerAnimationPhaseSlideSettle:
+      data->slide_settle_anim_progress = 0;
+      break;
+    default:
+      break;
+  }
 
-  if (data->bump_is_upwards == true) {
-    data->callbacks.increment(data->selected_cell_idx, 1, data->context);
-  } else {
-    data->callbacks.decrement(data->selected_cell_idx, 1, data->context);
+  // The settle phases are only decoration, they are the first thing dropped when drawing is slow or
+  // the battery is low
+  if ((next_phase == SelectionLayerAnimationPhaseBumpSettle || next_phase == SelectionLayerAnimationPhaseSlideSettle) &&
+      (frame_watchdog_get_level(&data->watchdog) >= FrameWatchdogLevelNoSettle || power_policy_is_low_power())) {
+    next_phase = SelectionLayerAnimationPhaseNone;
   }
 
-  animation_destroy(animation);
+  track->phase = next_phase;
+  track->phase_start_ms = end_time_ms;
+}
 
-  Animation *bump_settle = prv_create_bump_settle_animation(layer);
-  animation_schedule(bump_settle);
+// Jumps a track straight to its end state, committing any pending value or selection change
+static void prv_finish_track(Layer *layer, SelectionLayerAnimationTrack *track) {
+  const uint32_t now = time_util_get_ms();
+  while (track->phase != SelectionLayerAnimationPhaseNone) {
+    prv_finish_phase(layer, track, now);
+  }
+  layer_mark_dirty(layer);
 }
 
-static void prv_bump_settle_impl(struct Animation *animation, const AnimationProgress distance_normalized) {
-  Layer *layer = (Layer*)animation_get_context(animation);
+static void prv_advance_track(Layer *layer, SelectionLayerAnimationTrack *track, uint32_t now) {
   SelectionLayerData *data = layer_get_data(layer);
+  // Phases run at double speed once the watchdog asks for short animations
+  const int speed_shift = (frame_watchdog_get_level(&data->watchdog) >= FrameWatchdogLevelShort) ? 1 : 0;
+
+  while (track->phase != SelectionLayerAnimationPhaseNone) {
+    const uint32_t duration = s_phase_durations_ms[track->phase] >> speed_shift;
+    const uint32_t elapsed = now - track->phase_start_ms;
+    if (elapsed < duration) {
+      prv_update_phase(layer, track->phase,
+                       ((elapsed << speed_shift) * s_phase_rates[track->phase]) >> PHASE_RATE_SHIFT);
+      return;
+    }
+    prv_finish_phase(layer, track, track->phase_start_ms + duration);
+  }
+}
 
-  data->bump_settle_anim_progress = (100 * distance_normalized) / ANIMATION_NORMALIZED_MAX;
-  layer_mark_dirty(layer);
+static bool prv_tracks_are_idle(SelectionLayerData *data) {
+  return data->value_change_track.phase == SelectionLayerAnimationPhaseNone &&
+         data->next_cell_track.phase == SelectionLayerAnimationPhaseNone;
 }
 
-static void prv_bump_settle_stopped(Animation *animation, bool finished, void *context) {
-  Layer *layer = (Layer*)animation_get_context(animation);
+// Applies all repeat steps that arrived since the last frame as a single value change
+static bool prv_flush_pending_delta(Layer *layer) {
   SelectionLayerData *data = layer_get_data(layer);
+  if (data->pending_delta == 0) {
+    return false;
+  }
 
-  data->bump_settle_anim_progress = 0;
-  animation_destroy(animation);
+  const bool is_upwards = (data->pending_delta > 0);
+  uint32_t remaining = is_upwards ? data->pending_delta : -data->pending_delta;
+  data->pending_delta = 0;
+  while (remaining) {
+    const uint16_t count = (remaining > UINT16_MAX) ? UINT16_MAX : remaining;
+    prv_change_value(layer, is_upwards, count);
+    remaining -= count;
+  }
+  return true;
 }
 
-static Animation* prv_create_bump_text_animation(Layer *layer) {
+static void prv_engine_tick(void *context);
+
+// Every frame. The scheduler spaces frames further apart in low power mode
+static void prv_engine_schedule_tick(Layer *layer) {
+  if (!frame_scheduler_schedule(prv_engine_tick, layer, FRAME_SCHEDULER_FRAME_MS)) {
+    // No tick will come to advance the tracks, so land them now rather than leave them mid-flight
+    SelectionLayerData *data = layer_get_data(layer);
+    prv_finish_track(layer, &data->value_change_track);
+    prv_finish_track(layer, &data->next_cell_track);
+    prv_flush_pending_delta(layer);
+  }
+}
+
+static void prv_engine_tick(void *context) {
+  Layer *layer = (Layer*)context;
   SelectionLayerData *data = layer_get_data(layer);
 
-  PropertyAnimation *bump_text_anim = property_animation_create_layer_frame(layer, NULL, NULL);
-  Animation *animation = property_animation_get_animation(bump_text_anim);
-  animation_set_curve(animation, AnimationCurveEaseIn);
-  animation_set_duration(animation, BUMP_TEXT_DURATION_MS);
-  AnimationHandlers anim_handler = {
-      .stopped = prv_bump_text_stopped,
-  };
-  animation_set_handlers(animation, anim_handler, layer);
+  bool needs_redraw = (data->input_queue_count > 0);
+  if (prv_process_input_queue(layer)) {
+    // The layer may have been destroyed by the complete callback or the window pop
+    return;
+  }
 
-  data->bump_text_impl = (AnimationImplementation) {
-    .update = prv_bump_text_impl,
-  };
-  animation_set_implementation(animation, &data->bump_text_impl);
+  const uint32_t now = time_util_get_ms();
+  needs_redraw |= !prv_tracks_are_idle(data);
+  prv_advance_track(layer, &data->value_change_track, now);
+  prv_advance_track(layer, &data->next_cell_track, now);
+  needs_redraw |= prv_flush_pending_delta(layer);
+  if (needs_redraw) {
+    layer_mark_dirty(layer);
+  }
+
+  const bool is_holding = (now - data->last_repeat_ms) < BUTTON_HOLD_RELEASE_MS;
+  if (!prv_tracks_are_idle(data) || is_holding) {
+    prv_engine_schedule_tick(layer);
+  }
+}
+
+static bool prv_engine_is_running(Layer *layer) {
+  return frame_scheduler_is_scheduled(prv_engine_tick, layer);
+}
 
-  return animation;
+static void prv_engine_start(Layer *layer) {
+  if (prv_engine_is_running(layer)) {
+    return;
+  }
+  prv_engine_schedule_tick(layer);
 }
 
-static Animation* prv_create_bump_settle_animation(Layer *layer) {
+static void prv_start_track(Layer *layer, SelectionLayerAnimationTrack *track, SelectionLayerAnimationPhase phase) {
   SelectionLayerData *data = layer_get_data(layer);
+  // An interrupted animation still commits its change before the new one starts
+  prv_finish_track(layer, track);
+
+  track->phase = phase;
+  track->phase_start_ms = time_util_get_ms();
+  if (frame_watchdog_get_level(&data->watchdog) >= FrameWatchdogLevelJumpToEnd) {
+    // Drawing can't keep up, apply the change with no animation at all
+    prv_finish_track(layer, track);
+    return;
+  }
+  prv_engine_start(layer);
+}
 
-  PropertyAnimation *bump_settle_anim = property_animation_create_layer_frame(layer, NULL, NULL);
-  Animation *animation = property_animation_get_animation(bump_settle_anim);
-  animation_set_curve(animation, AnimationCurveEaseOut);
-  animation_set_duration(animation, BUMP_SETTLE_DURATION_MS);
-  AnimationHandlers anim_handler = {
-      .stopped = prv_bump_settle_stopped,
-  };
-  animation_set_handlers(animation, anim_handler, layer);
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Increment / Decrement Animation
 
-  data->bump_settle_anim_impl = (AnimationImplementation) {
-    .update = prv_bump_settle_impl,
-  };
-  animation_set_implementation(animation, &data->bump_settle_anim_impl);
+//! This animation causes a the active cell to "bump" when the user presses the up button.
+//! This animation has two parts:
+//! 1) The "text to cell edge"
+//! 2) The "background settle"
 
-  return animation;
-}
+//! The "text to cell edge" (bump_text) moves the text until it hits the top / bottom of the cell.
+
+//! The "background settle" (bump_settle) is a reaction to the "text to cell edge" animation.
+//! The top of the cell immediately expands down giving the impression that the text "pushed" the
+//! cell making it bigger. The cell then shrinks / settles back to its original height
+//! with the text vertically centered
 
 static void prv_run_value_change_animation(Layer *layer) {
   SelectionLayerData *data = layer_get_data(layer);
-
-  Animation *bump_text = prv_create_bump_text_animation(layer);
-  Animation *bump_settle = prv_create_bump_settle_animation(layer);
-  data->value_change_animation = animation_sequence_create(bump_text, bump_settle, NULL);
-  animation_schedule(data->value_change_animation);
+  prv_start_track(layer, &data->value_change_track, SelectionLayerAnimationPhaseBumpText);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -316,144 +670,160 @@ static void prv_run_value_change_animation(Layer *layer) {
 //! The "settle" (slide_settle) removes the extra width that was added in the "move and expand"
 //! step.
 
-static void prv_slide_impl(struct Animation *animation, const AnimationProgress distance_normalized) {
-  Layer *layer = (Layer*) animation_get_context(animation);
+static void prv_run_slide_animation(Layer *layer) {
   SelectionLayerData *data = layer_get_data(layer);
-
-  data->slide_amin_progress = (100 * distance_normalized) / ANIMATION_NORMALIZED_MAX;
-  layer_mark_dirty(layer);
+  prv_start_track(layer, &data->next_cell_track, SelectionLayerAnimationPhaseSlide);
 }
 
-static void prv_slide_stopped(Animation *animation, bool finished, void *context) {
-  Layer *layer = (Layer*)animation_get_context(animation);
-  SelectionLayerData *data = layer_get_data(layer);
-
-  data->slide_amin_progress = 0;
-
-  if (data->slide_is_forward) {
-    data->selected_cell_idx++;
-  } else {
-    data->selected_cell_idx--;
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Input queue
+
+//! Presses are queued and applied in order. Before an input is applied, everything in flight is
+//! jumped to its end state and committed, so every input acts on the real value and selection,
+//! and the value shown never lags more than one frame behind the user.
+//! When the engine is idle the queue is drained straight away. While it is running, the queue is
+//! drained at the start of the next frame. Every input that arrived within that frame except the
+//! last is then applied without animating.
+
+static void prv_enqueue_input(SelectionLayerData *data, SelectionLayerInput input) {
+  if (data->input_queue_count >= SELECTION_LAYER_INPUT_QUEUE_SIZE) {
+    // More presses than this within a single frame are not humanly possible
+    return;
   }
 
-  animation_destroy(animation);
-
-  Animation *settle_animation = prv_create_slide_settle_animation(layer);
-  animation_schedule(settle_animation);
+  const int tail = (data->input_queue_head + data->input_queue_count) % SELECTION_LAYER_INPUT_QUEUE_SIZE;
+  data->input_queue[tail] = input;
+  data->input_queue_count++;
 }
 
-static void prv_slide_settle_impl(struct Animation *animation, const AnimationProgress distance_normalized) {
-  Layer *layer = (Layer*)animation_get_context(animation);
-  SelectionLayerData *data = layer_get_data(layer);
-
-  data->slide_settle_anim_progress = 100 - ((100 * distance_normalized) / ANIMATION_NORMALIZED_MAX);
-  layer_mark_dirty(layer);
-}
-
-static void prv_slide_settle_stopped(Animation *animation, bool finished, void *context) {
-  Layer *layer = (Layer*) animation_get_context(animation);
-  SelectionLayerData *data = layer_get_data(layer);
-
-  data->slide_settle_anim_progress = 0;
-  animation_destroy(animation);
+static SelectionLayerInput prv_dequeue_input(SelectionLayerData *data) {
+  const SelectionLayerInput input = data->input_queue[data->input_queue_head];
+  data->input_queue_head = (data->input_queue_head + 1) % SELECTION_LAYER_INPUT_QUEUE_SIZE;
+  data->input_queue_count--;
+  return input;
 }
 
-static Animation* prv_create_slide_animation(Layer *layer) {
+// Returns true if the input handed control back to the owner (complete or window pop), after which
+// the layer must not be touched again
+static bool prv_apply_input(Layer *layer, SelectionLayerInput input, bool animated) {
   SelectionLayerData *data = layer_get_data(layer);
 
-  PropertyAnimation *slide_amin = property_animation_create_layer_frame(layer, NULL, NULL);
-  Animation *animation = property_animation_get_animation(slide_amin);
-  animation_set_curve(animation, AnimationCurveEaseIn);
-  animation_set_duration(animation, SLIDE_DURATION_MS);
-  AnimationHandlers anim_handler = {
-      .stopped = prv_slide_stopped,
-  };
-  animation_set_handlers(animation, anim_handler, layer);
+  // Land whatever is in flight so the input acts on the committed state
+  prv_finish_track(layer, &data->value_change_track);
+  prv_finish_track(layer, &data->next_cell_track);
 
-  data->slide_amin_impl = (AnimationImplementation) {
-    .update = prv_slide_impl,
-  };
-  animation_set_implementation(animation, &data->slide_amin_impl);
+  switch (input) {
+    case SelectionLayerInputUp:
+    case SelectionLayerInputDown:
+      data->bump_is_upwards = (input == SelectionLayerInputUp);
+      prv_run_value_change_animation(layer);
+      if (!animated) {
+        prv_finish_track(layer, &data->value_change_track);
+      }
+      return false;
+    case SelectionLayerInputNext:
+      if (data->selected_cell_idx >= data->num_cells - 1) {
+        data->selected_cell_idx = 0;
+        layer_mark_dirty(layer);
+        data->callbacks.complete(data->context);
+        return true;
+      }
+      data->slide_is_forward = true;
+      break;
+    case SelectionLayerInputPrevious:
+      if (data->selected_cell_idx == 0) {
+        window_stack_pop(true);
+        return true;
+      }
+      data->slide_is_forward = false;
+      break;
+  }
 
-  return animation;
+  const int next_idx = data->selected_cell_idx + (data->slide_is_forward ? 1 : -1);
+  data->slide_changes_row = (prv_get_row(data, next_idx) != prv_get_row(data, data->selected_cell_idx));
+  prv_run_slide_animation(layer);
+  if (!animated) {
+    prv_finish_track(layer, &data->next_cell_track);
+  }
+  return false;
 }
 
-static Animation* prv_create_slide_settle_animation(Layer *layer) {
+static bool prv_process_input_queue(Layer *layer) {
   SelectionLayerData *data = layer_get_data(layer);
-  PropertyAnimation *slide_settle_anim = property_animation_create_layer_frame(layer, NULL, NULL);
-  Animation *animation = property_animation_get_animation(slide_settle_anim);
-  animation_set_curve(animation, AnimationCurveEaseOut);
-  animation_set_duration(animation, SLIDE_SETTLE_DURATION_MS);
-  AnimationHandlers anim_handler = {
-      .stopped = prv_slide_settle_stopped,
-  };
-  animation_set_handlers(animation, anim_handler, layer);
 
-  data->slide_settle_anim_impl = (AnimationImplementation) {
-    .update = prv_slide_settle_impl,
-  };
-  animation_set_implementation(animation, &data->slide_settle_anim_impl);
-
-  return animation;
+  while (data->input_queue_count > 0) {
+    const SelectionLayerInput input = prv_dequeue_input(data);
+    const bool is_last = (data->input_queue_count == 0);
+    if (prv_apply_input(layer, input, is_last)) {
+      return true;
+    }
+  }
+  return false;
 }
 
-static void prv_run_slide_animation(Layer *layer) {
+static void prv_handle_input(Layer *layer, SelectionLayerInput input) {
   SelectionLayerData *data = layer_get_data(layer);
 
-  Animation *over_animation = prv_create_slide_animation(layer);
-  Animation *settle_animation = prv_create_slide_settle_animation(layer);
-  data->next_cell_animation = animation_sequence_create(over_animation, settle_animation, NULL);
-  animation_schedule(data->next_cell_animation);
+  prv_enqueue_input(data, input);
+  if (!prv_engine_is_running(layer)) {
+    prv_process_input_queue(layer);
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 //! Click handlers
 
-void prv_up_click_handler(ClickRecognizerRef recognizer, void *context) {
-  Layer *layer = (Layer*)context;
-  SelectionLayerData *data = layer_get_data(layer);
+static int32_t prv_get_repeat_step(SelectionLayerData *data, uint32_t now) {
+  const SelectionLayerRepeatAcceleration *acceleration = &data->repeat_acceleration;
+  uint32_t step = acceleration->initial_step;
 
-  if (data->is_active) {
-    if (click_recognizer_is_repeating(recognizer)) {
-      // Don't animate if the button is being held down. Just update the text
-      data->callbacks.increment(data->selected_cell_idx, click_number_of_clicks_counted(recognizer), data->context);
-      layer_mark_dirty(layer);
-    } else {
-      data->bump_is_upwards = true;
-      prv_run_value_change_animation(layer);
+  // The step doubles every growth interval the button has been held for
+  if (acceleration->step_growth_interval_ms) {
+    uint32_t doublings = (now - data->hold_start_ms) / acceleration->step_growth_interval_ms;
+    while (doublings-- && step < acceleration->max_step) {
+      step <<= 1;
     }
   }
+
+  if (step > acceleration->max_step) {
+    step = acceleration->max_step;
+  }
+  return step;
 }
 
-void prv_down_click_handler(ClickRecognizerRef recognizer, void *context) {
-  Layer *layer = (Layer*)context;
+static void prv_value_click_handler(ClickRecognizerRef recognizer, Layer *layer, bool is_upwards) {
   SelectionLayerData *data = layer_get_data(layer);
 
   if (data->is_active) {
+    const uint32_t now = time_util_get_ms();
     if (click_recognizer_is_repeating(recognizer)) {
-      // Don't animate if the button is being held down. Just update the text
-      data->callbacks.decrement(data->selected_cell_idx, click_number_of_clicks_counted(recognizer), data->context);
-      layer_mark_dirty(layer);
+      // Don't animate if the button is being held down. Collect the step and let the engine apply
+      // everything that arrived within a frame as one change
+      const int32_t step = prv_get_repeat_step(data, now);
+      data->pending_delta += is_upwards ? step : -step;
+      data->last_repeat_ms = now;
+      prv_engine_start(layer);
     } else {
-      data->bump_is_upwards = false;
-      prv_run_value_change_animation(layer);
+      data->hold_start_ms = now;
+      prv_handle_input(layer, is_upwards ? SelectionLayerInputUp : SelectionLayerInputDown);
     }
   }
 }
 
+void prv_up_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_value_click_handler(recognizer, (Layer*)context, true);
+}
+
+void prv_down_click_handler(ClickRecognizerRef recognizer, void *context) {
+  prv_value_click_handler(recognizer, (Layer*)context, false);
+}
+
 void prv_select_click_handler(ClickRecognizerRef recognizer, void *context) {
   Layer *layer = (Layer*)context;
   SelectionLayerData *data = layer_get_data(layer);
 
   if (data->is_active) {
-    animation_unschedule(data->next_cell_animation);
-    if (data->selected_cell_idx >= data->num_cells - 1) {
-      data->selected_cell_idx = 0;
-      data->callbacks.complete(data->context);
-    } else {
-      data->slide_is_forward = true;
-      prv_run_slide_animation(layer);
-    }
+    prv_handle_input(layer, SelectionLayerInputNext);
   }
 }
 
@@ -462,14 +832,7 @@ void prv_back_click_handler(ClickRecognizerRef recognizer, void *context) {
   SelectionLayerData *data = layer_get_data(layer);
 
   if (data->is_active) {
-    animation_unschedule(data->next_cell_animation);
-    if (data->selected_cell_idx == 0) {
-      data->selected_cell_idx = 0;
-      window_stack_pop(true);
-    } else {
-      data->slide_is_forward = false;
-      prv_run_slide_animation(layer);
-    }
+    prv_handle_input(layer, SelectionLayerInputPrevious);
   }
 }
 
@@ -489,26 +852,34 @@ static void prv_click_config_provider(Layer *layer) {
 //! API
 
 static Layer* selection_layer_init(SelectionLayerData *selection_layer_, GRect frame, int num_cells) {
-  Layer *layer = layer_create_with_data(frame, sizeof(SelectionLayerData));
-  SelectionLayerData *selection_layer_data = layer_get_data(layer);
+  if (num_cells < 0) {
+    num_cells = 0;
+  }
 
-  if (num_cells > MAX_SELECTION_LAYER_CELLS) {
-    num_cells = MAX_SELECTION_LAYER_CELLS;
+  Layer *layer = layer_create_with_data(frame, sizeof(SelectionLayerData) + (num_cells * sizeof(SelectionLayerCell)));
+  if (!layer) {
+    return NULL;
   }
+  SelectionLayerData *selection_layer_data = layer_get_data(layer);
 
   // Set layer defaults
   *selection_layer_data = (SelectionLayerData) {
     .active_background_color = DEFAULT_ACTIVE_COLOR,
     .inactive_background_color = DEFAULT_INACTIVE_COLOR,
     .num_cells = num_cells,
+    .num_columns = (num_cells > 0) ? num_cells : 1,
     .cell_padding = DEFAULT_CELL_PADDING,
     .selected_cell_idx = DEFAULT_SELECTED_INDEX,
     .font = fonts_get_system_font(DEFAULT_FONT),
+    .repeat_acceleration = DEFAULT_REPEAT_ACCELERATION,
     .is_active = true,
   };
   for (int i = 0; i < num_cells; i++) {
-    selection_layer_data->cell_widths[i] = 0;
+    selection_layer_data->cells[i] = (SelectionLayerCell) {0};
   }
+  frame_watchdog_init(&selection_layer_data->watchdog, FRAME_BUDGET_MS);
+  prv_rebuild_cell_geometry(layer);
+  prv_update_font_metrics(selection_layer_data);
   layer_set_frame(layer, frame);
   layer_set_clips(layer, false);
   layer_set_update_proc(layer, (LayerUpdateProc)prv_draw_selection_layer);
@@ -526,10 +897,14 @@ static void selection_layer_deinit(Layer* layer) {
 }
 
 void selection_layer_destroy(Layer* layer) {
+  if (!layer) {
+    return;
+  }
   SelectionLayerData *data = layer_get_data(layer);
 
-  animation_unschedule_all();
   if (data) {
+    // Only stop the tick this layer owns, other layers and windows keep animating
+    frame_scheduler_cancel(prv_engine_tick, layer);
     selection_layer_deinit(layer);
   }
 }
@@ -537,8 +912,10 @@ void selection_layer_destroy(Layer* layer) {
 void selection_layer_set_cell_width(Layer *layer, int idx, int width) {
   SelectionLayerData *data = layer_get_data(layer);
 
-  if (data && idx < data->num_cells) {
-    data->cell_widths[idx] = width;
+  if (data && idx >= 0 && idx < data->num_cells) {
+    data->cells[idx].width = width;
+    prv_rebuild_cell_geometry(layer);
+    layer_mark_dirty(layer);
   }
 }
 
@@ -547,6 +924,8 @@ void selection_layer_set_font(Layer *layer, GFont font) {
 
   if (data) {
     data->font = font;
+    prv_update_font_metrics(data);
+    layer_mark_dirty(layer);
   }
 }
 
@@ -555,6 +934,7 @@ void selection_layer_set_inactive_bg_color(Layer *layer, GColor color) {
 
   if (data) {
     data->inactive_background_color = color;
+    layer_mark_dirty(layer);
   }
 }
 
@@ -563,6 +943,7 @@ void selection_layer_set_active_bg_color(Layer *layer, GColor color) {
 
   if (data) {
     data->active_background_color = color;
+    layer_mark_dirty(layer);
   }
 }
 
@@ -571,9 +952,30 @@ void selection_layer_set_cell_padding(Layer *layer, int padding) {
 
   if (data) {
     data->cell_padding = padding;
+    prv_rebuild_cell_geometry(layer);
+    layer_mark_dirty(layer);
   }
 }
 
+void selection_layer_set_num_columns(Layer *layer, int num_columns) {
+  SelectionLayerData *data = layer_get_data(layer);
+
+  if (data && num_columns > 0) {
+    data->num_columns = num_columns;
+    prv_rebuild_cell_geometry(layer);
+    layer_mark_dirty(layer);
+  }
+}
+
+GRect selection_layer_get_cell_frame(Layer *layer, int idx) {
+  SelectionLayerData *data = layer_get_data(layer);
+
+  if (data && idx >= 0 && idx < data->num_cells) {
+    return data->cells[idx].frame;
+  }
+  return GRectZero;
+}
+
 void selection_layer_set_active(Layer *layer, bool is_active) {
   SelectionLayerData *data = layer_get_data(layer);
 
@@ -581,7 +983,11 @@ void selection_layer_set_active(Layer *layer, bool is_active) {
     if (is_active && !data->is_active) {
       data->selected_cell_idx = 0;
     } if (!is_active && data->is_active) {
-      data->selected_cell_idx = MAX_SELECTION_LAYER_CELLS + 1;
+      // Drop queued presses and land anything in flight while the selection is still valid
+      data->input_queue_count = 0;
+      prv_finish_track(layer, &data->value_change_track);
+      prv_finish_track(layer, &data->next_cell_track);
+      data->selected_cell_idx = INVALID_CELL_INDEX;
     }
 
     data->is_active = is_active;
@@ -599,4 +1005,43 @@ void selection_layer_set_callbacks(Layer *layer, void *context, SelectionLayerCa
   SelectionLayerData *data = layer_get_data(layer);
   data->callbacks = callbacks;
   data->context = context;
+  prv_invalidate_all_cell_text(data);
+}
+
+void selection_layer_set_repeat_acceleration(Layer *layer, SelectionLayerRepeatAcceleration acceleration) {
+  SelectionLayerData *data = layer_get_data(layer);
+
+  if (data) {
+    if (acceleration.initial_step == 0) {
+      acceleration.initial_step = 1;
+    }
+    if (acceleration.max_step < acceleration.initial_step) {
+      acceleration.max_step = acceleration.initial_step;
+    }
+    data->repeat_acceleration = acceleration;
+  }
+}
+
+void selection_layer_set_cache_cell_text(Layer *layer, bool cache_cell_text) {
+  SelectionLayerData *data = layer_get_data(layer);
+
+  if (data) {
+    data->cache_cell_text = cache_cell_text;
+    prv_invalidate_all_cell_text(data);
+    layer_mark_dirty(layer);
+  }
+}
+
+void selection_layer_invalidate_cell(Layer *layer, int idx) {
+  SelectionLayerData *data = layer_get_data(layer);
+
+  if (data) {
+    prv_invalidate_cell_text(data, idx);
+    layer_mark_dirty(layer);
+  }
+}
+
+FrameWatchdogLevel selection_layer_get_animation_level(Layer *layer) {
+  SelectionLayerData *data = layer_get_data(layer);
+  return data ? frame_watchdog_get_level(&data->watchdog) : FrameWatchdogLevelFull;
 }
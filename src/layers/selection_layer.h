@@ -2,15 +2,23 @@
 
 #include <pebble.h>
 
-#define MAX_SELECTION_LAYER_CELLS 3
+#include "../modules/frame_scheduler.h"
+#include "../modules/frame_watchdog.h"
+
+// Longest string (including the terminator) a cell can hold when its text is cached
+#define SELECTION_LAYER_CELL_TEXT_LENGTH 8
+// Presses that can be queued between two animation frames
+#define SELECTION_LAYER_INPUT_QUEUE_SIZE 4
 
 typedef char* (*SelectionLayerGetCellText)(int index, void *context);
 
 typedef void (*SelectionLayerCompleteCallback)(void *context);
 
-typedef void (*SelectionLayerIncrementCallback)(int selected_cell_idx, uint8_t reapeating_count, void *context);
+// count is the number of steps to move the value by. It is 1 for a single press and may be larger
+// while a button is held, see SelectionLayerRepeatAcceleration
+typedef void (*SelectionLayerIncrementCallback)(int selected_cell_idx, uint16_t count, void *context);
 
-typedef void (*SelectionLayerDecrementCallback)(int selected_cell_idx, uint8_t reapeating_count, void *context);
+typedef void (*SelectionLayerDecrementCallback)(int selected_cell_idx, uint16_t count, void *context);
 
 typedef struct SelectionLayerCallbacks {
   SelectionLayerGetCellText get_cell_text;
@@ -19,9 +27,48 @@ typedef struct SelectionLayerCallbacks {
   SelectionLayerDecrementCallback decrement;
 } SelectionLayerCallbacks;
 
+// Controls how fast the value changes while up / down is held. The step starts at initial_step and
+// doubles every step_growth_interval_ms up to max_step. The default of { 1, 1, 0 } steps by one
+// per repeat. { 1, 1000, 150 } takes a cell from 0 to 9999 in about two and a half seconds.
+typedef struct SelectionLayerRepeatAcceleration {
+  uint16_t initial_step;
+  uint16_t max_step;
+  uint16_t step_growth_interval_ms;
+} SelectionLayerRepeatAcceleration;
+
+typedef enum {
+  SelectionLayerInputUp,
+  SelectionLayerInputDown,
+  SelectionLayerInputNext,
+  SelectionLayerInputPrevious,
+} SelectionLayerInput;
+
+typedef enum {
+  SelectionLayerAnimationPhaseNone = 0,
+  SelectionLayerAnimationPhaseBumpText,
+  SelectionLayerAnimationPhaseBumpSettle,
+  SelectionLayerAnimationPhaseSlide,
+  SelectionLayerAnimationPhaseSlideSettle,
+} SelectionLayerAnimationPhase;
+
+typedef struct SelectionLayerAnimationTrack {
+  SelectionLayerAnimationPhase phase;
+  uint32_t phase_start_ms;
+} SelectionLayerAnimationTrack;
+
+typedef struct SelectionLayerCell {
+  int width;
+  // Position of the cell in the layer, rebuilt whenever a width, the padding or the grid changes
+  GRect frame;
+
+  bool text_is_valid;
+  char text[SELECTION_LAYER_CELL_TEXT_LENGTH];
+} SelectionLayerCell;
+
 typedef struct SelectionLayerData {
   int num_cells;
-  int cell_widths[MAX_SELECTION_LAYER_CELLS];
+  // Cells are laid out in rows of num_columns, by default all cells share one row
+  int num_columns;
   int cell_padding;
   int selected_cell_idx;
 
@@ -29,26 +76,51 @@ typedef struct SelectionLayerData {
   bool is_active;
 
   GFont font;
+  // Height of the glyphs and the empty space above them. Cached when the font is set for the
+  // system fonts with hand tuned metrics, other fonts are measured on the next draw
+  int font_height;
+  int font_top_padding;
+  bool font_metrics_are_valid;
   GColor inactive_background_color;
   GColor active_background_color;
 
   SelectionLayerCallbacks callbacks;
   void *context;
+  // If cache_cell_text = true get_cell_text is only called after a cell's value has changed
+  bool cache_cell_text;
 
   // Animation stuff
-  Animation *value_change_animation;
+  // A single frame scheduler tick drives both tracks, see "Animation engine" in selection_layer.c.
+  // It is keyed on the layer, so several layers can coexist in one window.
+  // Times each draw, and cuts the animations back if drawing can't keep up
+  FrameWatchdog watchdog;
+
+  // Progress values range from 0 to ANIMATION_NORMALIZED_MAX
+  SelectionLayerAnimationTrack value_change_track;
   bool bump_is_upwards;
-  int bump_text_anim_progress;
-  AnimationImplementation bump_text_impl;
-  int bump_settle_anim_progress;
-  AnimationImplementation bump_settle_anim_impl;
+  AnimationProgress bump_text_anim_progress;
+  AnimationProgress bump_settle_anim_progress;
 
-  Animation *next_cell_animation;
+  SelectionLayerInput input_queue[SELECTION_LAYER_INPUT_QUEUE_SIZE];
+  uint8_t input_queue_head;
+  uint8_t input_queue_count;
+
+  // Hold to repeat
+  SelectionLayerRepeatAcceleration repeat_acceleration;
+  uint32_t hold_start_ms;
+  uint32_t last_repeat_ms;
+  // Steps accumulated since the last frame, positive is upwards
+  int32_t pending_delta;
+
+  SelectionLayerAnimationTrack next_cell_track;
   bool slide_is_forward;
-  int slide_amin_progress;
-  AnimationImplementation slide_amin_impl;
-  int slide_settle_anim_progress;
-  AnimationImplementation slide_settle_anim_impl;
+  // True when the slide moves between rows
+  bool slide_changes_row;
+  AnimationProgress slide_amin_progress;
+  AnimationProgress slide_settle_anim_progress;
+
+  // Sized to num_cells when the layer is created
+  SelectionLayerCell cells[];
 } SelectionLayerData;
 
 Layer* selection_layer_create(GRect frame, int num_cells);
@@ -57,6 +129,9 @@ void selection_layer_destroy(Layer* layer);
 
 void selection_layer_set_cell_width(Layer *layer, int cell_idx, int width);
 
+// Fonts other than GOTHIC_24_BOLD and GOTHIC_28_BOLD are measured by drawing a digit into the frame
+// buffer on the next draw. If the layer's corner is off screen at that point the text is centred
+// by its line height instead, which leaves it slightly low
 void selection_layer_set_font(Layer *layer, GFont font);
 
 void selection_layer_set_inactive_bg_color(Layer *layer, GColor color);
@@ -65,9 +140,29 @@ void selection_layer_set_active_bg_color(Layer *layer, GColor color);
 
 void selection_layer_set_cell_padding(Layer *layer, int padding);
 
+// Lays the cells out as a grid with num_columns cells per row, filled in reading order. Select and
+// back move through the cells in that order. Changing rows, the selection wipes out of the end of
+// one row and into the start of the other rather than sliding across the grid.
+void selection_layer_set_num_columns(Layer *layer, int num_columns);
+
+// Returns the frame of a cell within the layer, or GRectZero for an invalid index
+GRect selection_layer_get_cell_frame(Layer *layer, int idx);
+
 // When transitioning from inactive -> active, the selected cell will be index 0
 void selection_layer_set_active(Layer *layer, bool is_active);
 
 void selection_layer_set_click_config_onto_window(Layer *layer, struct Window *window);
 
 void selection_layer_set_callbacks(Layer *layer, void *context, SelectionLayerCallbacks callbacks);
+
+void selection_layer_set_repeat_acceleration(Layer *layer, SelectionLayerRepeatAcceleration acceleration);
+
+// Store each cell's text and only ask get_cell_text for it again after the layer has called
+// increment / decrement for that cell, or after selection_layer_invalidate_cell
+void selection_layer_set_cache_cell_text(Layer *layer, bool cache_cell_text);
+
+// Marks the cached text of a cell as stale so it is fetched again on the next draw
+void selection_layer_invalidate_cell(Layer *layer, int idx);
+
+// Returns how far the animations have been cut back because drawing was going over budget
+FrameWatchdogLevel selection_layer_get_animation_level(Layer *layer);
@@ -10,50 +10,43 @@
 #include "windows/progress_bar_window.h"
 #include "windows/progress_layer_window.h"
 #include "windows/dialog_config_window.h"
+#include "modules/power_policy.h"
 
-#define NUM_WINDOWS 10
+// One row of the main menu, the table itself is generated from main_menu.json at build time
+typedef struct {
+  const char *title;
+  // 0 if the row has no icon
+  uint32_t icon_resource_id;
+  void (*push)(void);
+} MainMenuItem;
 
 static Window *s_main_window;
 static MenuLayer *s_menu_layer;
 
+static void pin_complete_callback(PIN pin, void *context) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "Pin was %d %d %d", pin.digits[0], pin.digits[1], pin.digits[2]);
+  pin_window_pop((PinWindow*)context, true);
+}
+
+static void pin_entry_push(void) {
+  PinWindow *pin_window = pin_window_create((PinWindowCallbacks) {
+    .pin_complete = pin_complete_callback
+  });
+  pin_window_push(pin_window, true);
+}
+
+// Generated from main_menu.json into the build directory, after pin_entry_push so the table can use it
+#include "src/main_menu.auto.h"
+
+static GBitmap *s_menu_icons[MAIN_MENU_NUM_ITEMS];
+
 static uint16_t get_num_rows_callback(MenuLayer *menu_layer, uint16_t section_index, void *context) {
-  return NUM_WINDOWS;
+  return MAIN_MENU_NUM_ITEMS;
 }
 
 static void draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuIndex *cell_index, void *context) {
-  switch(cell_index->row) {
-    case 0:
-      menu_cell_basic_draw(ctx, cell_layer, "Checkbox List", NULL, NULL);
-      break;
-    case 1:
-      menu_cell_basic_draw(ctx, cell_layer, "Choice Dialog", NULL, NULL);
-      break;
-    case 2:
-      menu_cell_basic_draw(ctx, cell_layer, "Message Dialog", NULL, NULL);
-      break;
-    case 3:
-      menu_cell_basic_draw(ctx, cell_layer, "List Message", NULL, NULL);
-      break;
-    case 4:
-      menu_cell_basic_draw(ctx, cell_layer, "Radio Button", NULL, NULL);
-      break;
-    case 5:
-      menu_cell_basic_draw(ctx, cell_layer, "PIN Entry", NULL, NULL);
-      break;
-    case 6:
-      menu_cell_basic_draw(ctx, cell_layer, "Text Animation", NULL, NULL);
-      break;
-    case 7:
-      menu_cell_basic_draw(ctx, cell_layer, "Progress Bar", NULL, NULL);
-      break;
-    case 8:
-      menu_cell_basic_draw(ctx, cell_layer, "Progress Layer", NULL, NULL);
-      break;
-    case 9:
-      menu_cell_basic_draw(ctx, cell_layer, "App Config Prompt", NULL, NULL);
-      break;
-    default:
-      break;
+  if (cell_index->row < MAIN_MENU_NUM_ITEMS) {
+    menu_cell_basic_draw(ctx, cell_layer, s_main_menu_items[cell_index->row].title, NULL, s_menu_icons[cell_index->row]);
   }
 }
 
@@ -64,49 +57,9 @@ static int16_t get_cell_height_callback(struct MenuLayer *menu_layer, MenuIndex
     CHECKBOX_WINDOW_CELL_HEIGHT);
 }
 
-static void pin_complete_callback(PIN pin, void *context) {
-  APP_LOG(APP_LOG_LEVEL_INFO, "Pin was %d %d %d", pin.digits[0], pin.digits[1], pin.digits[2]);
-  pin_window_pop((PinWindow*)context, true);
-}
-
 static void select_callback(struct MenuLayer *menu_layer, MenuIndex *cell_index, void *context) {
-  switch(cell_index->row) {
-    case 0:
-      checkbox_window_push();
-      break;
-    case 1:
-      dialog_choice_window_push();
-      break;
-    case 2:
-      dialog_message_window_push();
-      break;
-    case 3:
-      list_message_window_push();
-      break;
-    case 4:
-      radio_button_window_push();
-      break;
-    case 5: {
-        PinWindow *pin_window = pin_window_create((PinWindowCallbacks) {
-          .pin_complete = pin_complete_callback
-        });
-        pin_window_push(pin_window, true);
-      }
-      break;
-    case 6:
-      text_animation_window_push();
-      break;
-    case 7:
-      progress_bar_window_push();
-      break;
-    case 8:
-      progress_layer_window_push();
-      break;
-    case 9:
-      dialog_config_window_push();
-      break;
-    default:
-      break;
+  if (cell_index->row < MAIN_MENU_NUM_ITEMS) {
+    s_main_menu_items[cell_index->row].push();
   }
 }
 
@@ -127,13 +80,27 @@ static void window_load(Window *window) {
       .select_click = select_callback,
   });
   layer_add_child(window_layer, menu_layer_get_layer(s_menu_layer));
+
+  for (int i = 0; i < MAIN_MENU_NUM_ITEMS; i++) {
+    const uint32_t icon_resource_id = s_main_menu_items[i].icon_resource_id;
+    s_menu_icons[i] = icon_resource_id ? gbitmap_create_with_resource(icon_resource_id) : NULL;
+  }
 }
 
 static void window_unload(Window *window) {
   menu_layer_destroy(s_menu_layer);
+
+  for (int i = 0; i < MAIN_MENU_NUM_ITEMS; i++) {
+    if (s_menu_icons[i]) {
+      gbitmap_destroy(s_menu_icons[i]);
+      s_menu_icons[i] = NULL;
+    }
+  }
 }
 
 static void init() {
+  power_policy_init();
+
   s_main_window = window_create();
   window_set_window_handlers(s_main_window, (WindowHandlers) {
       .load = window_load,
@@ -144,6 +111,7 @@ static void init() {
 
 static void deinit() {
   window_destroy(s_main_window);
+  power_policy_deinit();
 }
 
 int main() {
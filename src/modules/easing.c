@@ -0,0 +1,102 @@
+#include "easing.h"
+
+// Each curve is sampled at EASING_SEGMENTS + 1 evenly spaced points, generated offline. Values are
+// in AnimationProgress units, so curves that overshoot go above ANIMATION_NORMALIZED_MAX
+#define EASING_SEGMENTS 32
+#define EASING_TABLE_SIZE (EASING_SEGMENTS + 1)
+// Width of each segment in AnimationProgress units, (ANIMATION_NORMALIZED_MAX + 1) / EASING_SEGMENTS
+#define EASING_SEGMENT_SHIFT 11
+#define EASING_SEGMENT_MASK ((1 << EASING_SEGMENT_SHIFT) - 1)
+
+// t^2
+static const int32_t s_ease_in[EASING_TABLE_SIZE] = {
+  0, 64, 256, 576, 1024, 1600, 2304, 3136,
+  4096, 5184, 6400, 7744, 9216, 10816, 12544, 14400,
+  16384, 18496, 20736, 23104, 25600, 28224, 30976, 33855,
+  36863, 39999, 43263, 46655, 50175, 53823, 57599, 61503,
+  65535,
+};
+
+// 1 - (1 - t)^2
+static const int32_t s_ease_out[EASING_TABLE_SIZE] = {
+  0, 4032, 7936, 11712, 15360, 18880, 22272, 25536,
+  28672, 31680, 34559, 37311, 39935, 42431, 44799, 47039,
+  49151, 51135, 52991, 54719, 56319, 57791, 59135, 60351,
+  61439, 62399, 63231, 63935, 64511, 64959, 65279, 65471,
+  65535,
+};
+
+// 2t^2, mirrored about the midpoint
+static const int32_t s_ease_in_out[EASING_TABLE_SIZE] = {
+  0, 128, 512, 1152, 2048, 3200, 4608, 6272,
+  8192, 10368, 12800, 15488, 18432, 21632, 25088, 28800,
+  32768, 36735, 40447, 43903, 47103, 50047, 52735, 55167,
+  57343, 59263, 60927, 62335, 63487, 64383, 65023, 65407,
+  65535,
+};
+
+// back out, passes the end by ~10% and returns
+static const int32_t s_overshoot[EASING_TABLE_SIZE] = {
+  0, 9224, 17661, 25344, 32304, 38574, 44187, 49174,
+  53569, 57404, 60710, 63522, 65870, 67788, 69308, 70462,
+  71282, 71802, 72053, 72068, 71880, 71520, 71022, 70417,
+  69738, 69018, 68288, 67582, 66932, 66369, 65927, 65638,
+  65535,
+};
+
+// 1 - cos(3 pi t) e^(-4t) (1 - t), a damped wobble around the end
+static const int32_t s_spring_settle[EASING_TABLE_SIZE] = {
+  0, 11920, 25750, 39640, 52225, 62634, 70442, 75596,
+  78321, 79022, 78196, 76357, 73979, 71458, 69094, 67085,
+  65535, 64470, 63856, 63621, 63671, 63911, 64251, 64618,
+  64958, 65238, 65442, 65569, 65630, 65639, 65615, 65576,
+  65535,
+};
+
+static const int32_t *const s_tables[EasingCurveCount] = {
+  [EasingCurveLinear] = NULL,
+  [EasingCurveEaseIn] = s_ease_in,
+  [EasingCurveEaseOut] = s_ease_out,
+  [EasingCurveEaseInOut] = s_ease_in_out,
+  [EasingCurveOvershoot] = s_overshoot,
+  [EasingCurveSpringSettle] = s_spring_settle,
+};
+
+AnimationProgress easing_apply(EasingCurve curve, AnimationProgress progress) {
+  const int32_t *table = (curve < EasingCurveCount) ? s_tables[curve] : NULL;
+  if (!table) {
+    return progress;
+  }
+
+  // Both ends are exact so that an animation always starts and finishes where it was asked to
+  if (progress <= 0) {
+    return table[0];
+  } else if (progress >= ANIMATION_NORMALIZED_MAX) {
+    return table[EASING_SEGMENTS];
+  }
+
+  const int32_t index = progress >> EASING_SEGMENT_SHIFT;
+  const int32_t fraction = progress & EASING_SEGMENT_MASK;
+  const int32_t start = table[index];
+  return start + (((table[index + 1] - start) * fraction) / (1 << EASING_SEGMENT_SHIFT));
+}
+
+AnimationProgress easing_curve_ease_in(AnimationProgress progress) {
+  return easing_apply(EasingCurveEaseIn, progress);
+}
+
+AnimationProgress easing_curve_ease_out(AnimationProgress progress) {
+  return easing_apply(EasingCurveEaseOut, progress);
+}
+
+AnimationProgress easing_curve_ease_in_out(AnimationProgress progress) {
+  return easing_apply(EasingCurveEaseInOut, progress);
+}
+
+AnimationProgress easing_curve_overshoot(AnimationProgress progress) {
+  return easing_apply(EasingCurveOvershoot, progress);
+}
+
+AnimationProgress easing_curve_spring_settle(AnimationProgress progress) {
+  return easing_apply(EasingCurveSpringSettle, progress);
+}
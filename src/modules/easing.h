@@ -0,0 +1,31 @@
+#pragma once
+
+#include <pebble.h>
+
+// Easing curves as precomputed fixed-point tables. Evaluating a curve is a table lookup and a
+// linear interpolation between two neighbouring samples, with no floating point or trig at runtime.
+
+typedef enum {
+  EasingCurveLinear,
+  EasingCurveEaseIn,
+  EasingCurveEaseOut,
+  EasingCurveEaseInOut,
+  // Runs past the end and comes back
+  EasingCurveOvershoot,
+  // Wobbles around the end before settling on it
+  EasingCurveSpringSettle,
+
+  EasingCurveCount,
+} EasingCurve;
+
+// Maps a linear progress in [0, ANIMATION_NORMALIZED_MAX] onto the curve. 0 and
+// ANIMATION_NORMALIZED_MAX map to themselves, but the overshoot and spring curves go above
+// ANIMATION_NORMALIZED_MAX in between
+AnimationProgress easing_apply(EasingCurve curve, AnimationProgress progress);
+
+// AnimationCurveFunction versions, for animation_set_custom_curve()
+AnimationProgress easing_curve_ease_in(AnimationProgress progress);
+AnimationProgress easing_curve_ease_out(AnimationProgress progress);
+AnimationProgress easing_curve_ease_in_out(AnimationProgress progress);
+AnimationProgress easing_curve_overshoot(AnimationProgress progress);
+AnimationProgress easing_curve_spring_settle(AnimationProgress progress);
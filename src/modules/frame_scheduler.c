@@ -0,0 +1,143 @@
+#include "frame_scheduler.h"
+
+typedef struct {
+  FrameSchedulerCallback callback;
+  void *context;
+  // Start of the frame the callback runs on
+  uint32_t due_ms;
+  // Set at the start of a tick for the slots that tick will run
+  bool is_due;
+} FrameSchedulerSlot;
+
+// Kept packed, the first s_num_slots entries are in use
+static FrameSchedulerSlot s_slots[FRAME_SCHEDULER_MAX_SLOTS];
+static uint8_t s_num_slots;
+
+static AppTimer *s_timer;
+static uint32_t s_timer_due_ms;
+static bool s_is_ticking;
+static uint32_t s_wakeup_count;
+
+// Start of the frame delay_ms worth of whole frames after the one now_ms falls in. Counting from
+// the current frame rather than from now_ms means a tick that ran a little late and asks for the
+// next frame still gets the very next one, not the one after
+static uint32_t prv_get_due_frame_ms(uint32_t now_ms, uint32_t delay_ms) {
+  const uint32_t frame_ms = power_policy_scale_interval(FRAME_SCHEDULER_FRAME_MS);
+  const uint32_t num_frames = (delay_ms + frame_ms - 1) / frame_ms;
+  return ((now_ms / frame_ms) + num_frames) * frame_ms;
+}
+
+static int prv_find_slot(FrameSchedulerCallback callback, void *context) {
+  for (int i = 0; i < s_num_slots; i++) {
+    if (s_slots[i].callback == callback && s_slots[i].context == context) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void prv_remove_slot(int index) {
+  s_slots[index] = s_slots[--s_num_slots];
+}
+
+static void prv_tick(void *context);
+
+// Points the timer at the earliest due slot, or stops it if there are none
+static void prv_update_timer(void) {
+  if (s_is_ticking) {
+    // The tick updates the timer once every due callback has run
+    return;
+  }
+
+  if (s_num_slots == 0) {
+    if (s_timer) {
+      app_timer_cancel(s_timer);
+      s_timer = NULL;
+    }
+    return;
+  }
+
+  uint32_t earliest_ms = s_slots[0].due_ms;
+  for (int i = 1; i < s_num_slots; i++) {
+    if ((int32_t)(s_slots[i].due_ms - earliest_ms) < 0) {
+      earliest_ms = s_slots[i].due_ms;
+    }
+  }
+  if (s_timer && earliest_ms == s_timer_due_ms) {
+    return;
+  }
+
+  const uint32_t now_ms = time_util_get_ms();
+  const uint32_t delay_ms = ((int32_t)(earliest_ms - now_ms) > 0) ? earliest_ms - now_ms : 0;
+  if (!s_timer || !app_timer_reschedule(s_timer, delay_ms)) {
+    s_timer = app_timer_register(delay_ms, prv_tick, NULL);
+  }
+  s_timer_due_ms = earliest_ms;
+}
+
+static void prv_tick(void *context) {
+  s_timer = NULL;
+  s_wakeup_count++;
+  s_is_ticking = true;
+
+  const uint32_t now_ms = time_util_get_ms();
+  for (int i = 0; i < s_num_slots; i++) {
+    s_slots[i].is_due = (int32_t)(s_slots[i].due_ms - now_ms) <= 0;
+  }
+
+  // Callbacks can schedule and cancel, so look the next due slot up again each time round. Anything
+  // scheduled from inside a callback waits for a later tick
+  for (;;) {
+    int index = -1;
+    for (int i = 0; i < s_num_slots; i++) {
+      if (s_slots[i].is_due) {
+        index = i;
+        break;
+      }
+    }
+    if (index < 0) {
+      break;
+    }
+
+    const FrameSchedulerSlot slot = s_slots[index];
+    prv_remove_slot(index);
+    slot.callback(slot.context);
+  }
+
+  s_is_ticking = false;
+  prv_update_timer();
+}
+
+bool frame_scheduler_schedule(FrameSchedulerCallback callback, void *context, uint32_t delay_ms) {
+  int index = prv_find_slot(callback, context);
+  if (index < 0) {
+    if (s_num_slots >= FRAME_SCHEDULER_MAX_SLOTS) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "FrameScheduler has no free slots");
+      return false;
+    }
+    index = s_num_slots++;
+    s_slots[index].callback = callback;
+    s_slots[index].context = context;
+  }
+
+  s_slots[index].due_ms = prv_get_due_frame_ms(time_util_get_ms(), delay_ms);
+  s_slots[index].is_due = false;
+  prv_update_timer();
+  return true;
+}
+
+void frame_scheduler_cancel(FrameSchedulerCallback callback, void *context) {
+  const int index = prv_find_slot(callback, context);
+  if (index >= 0) {
+    prv_remove_slot(index);
+    prv_update_timer();
+  }
+}
+
+bool frame_scheduler_is_scheduled(FrameSchedulerCallback callback, void *context) {
+  return prv_find_slot(callback, context) >= 0;
+}
+
+uint32_t frame_scheduler_get_wakeup_count(void) {
+  return s_wakeup_count;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "power_policy.h"
+#include "time_util.h"
+
+// Runs timed callbacks for the whole app from a single AppTimer. Callbacks that fall due in the
+// same frame are run together on one wakeup at the frame boundary, and the timer is stopped
+// entirely while nothing is scheduled. In low power mode frames are spaced further apart.
+
+#define FRAME_SCHEDULER_FRAME_MS 33
+#define FRAME_SCHEDULER_MAX_SLOTS 8
+
+typedef void (*FrameSchedulerCallback)(void *context);
+
+// Runs callback once, delay_ms rounded up to whole frames after the start of the current frame, so
+// a delay of FRAME_SCHEDULER_FRAME_MS always means the next frame even when called a little late.
+// A callback and context pair has at most one slot, so scheduling it again moves it. Returns false
+// if every slot is in use, callers must then finish whatever they were going to do in the callback
+bool frame_scheduler_schedule(FrameSchedulerCallback callback, void *context, uint32_t delay_ms);
+
+// Safe to call whether or not the pair is scheduled, including from inside a callback
+void frame_scheduler_cancel(FrameSchedulerCallback callback, void *context);
+
+bool frame_scheduler_is_scheduled(FrameSchedulerCallback callback, void *context);
+
+// Number of times the scheduler's timer has woken the app up
+uint32_t frame_scheduler_get_wakeup_count(void);
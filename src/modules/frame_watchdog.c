@@ -0,0 +1,55 @@
+#include "frame_watchdog.h"
+
+static void prv_recover(FrameWatchdog *watchdog, uint32_t now_ms) {
+  if (watchdog->level != FrameWatchdogLevelFull &&
+      (now_ms - watchdog->level_change_ms) >= FRAME_WATCHDOG_RECOVER_MS) {
+    watchdog->level--;
+    watchdog->level_change_ms = now_ms;
+  }
+}
+
+void frame_watchdog_init(FrameWatchdog *watchdog, uint16_t budget_ms) {
+  *watchdog = (FrameWatchdog) {
+    .budget_ms = budget_ms,
+    .level = FrameWatchdogLevelFull,
+  };
+}
+
+void frame_watchdog_begin_frame(FrameWatchdog *watchdog) {
+  watchdog->frame_start_ms = time_util_get_ms();
+  watchdog->frame_is_open = true;
+}
+
+void frame_watchdog_end_frame(FrameWatchdog *watchdog) {
+  if (!watchdog->frame_is_open) {
+    return;
+  }
+  watchdog->frame_is_open = false;
+
+  const uint32_t now_ms = time_util_get_ms();
+  if ((now_ms - watchdog->frame_start_ms) <= watchdog->budget_ms) {
+    watchdog->overrun_frames = 0;
+    prv_recover(watchdog, now_ms);
+    return;
+  }
+
+  if (++watchdog->overrun_frames < FRAME_WATCHDOG_OVERRUN_FRAMES) {
+    return;
+  }
+  watchdog->overrun_frames = 0;
+  watchdog->level_change_ms = now_ms;
+  if (watchdog->level != FrameWatchdogLevelJumpToEnd) {
+    watchdog->level++;
+    watchdog->degrade_count++;
+  }
+}
+
+FrameWatchdogLevel frame_watchdog_get_level(FrameWatchdog *watchdog) {
+  // Also recovers while nothing is being drawn
+  prv_recover(watchdog, time_util_get_ms());
+  return watchdog->level;
+}
+
+uint32_t frame_watchdog_get_degrade_count(FrameWatchdog *watchdog) {
+  return watchdog->degrade_count;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "time_util.h"
+
+// Times a component's drawing against a frame budget. A component that keeps going over budget
+// is stepped down to a cheaper way of animating, one level at a time, and is stepped back up
+// again once it has stayed within budget for a while.
+
+// Consecutive over budget frames before dropping a level
+#define FRAME_WATCHDOG_OVERRUN_FRAMES 3
+// Time without an overrun before going back up a level
+#define FRAME_WATCHDOG_RECOVER_MS 2000
+
+typedef enum {
+  // Animate everything
+  FrameWatchdogLevelFull,
+  // Skip settle and overshoot phases
+  FrameWatchdogLevelNoSettle,
+  // Also halve animation durations
+  FrameWatchdogLevelShort,
+  // Don't animate, jump straight to end states
+  FrameWatchdogLevelJumpToEnd,
+} FrameWatchdogLevel;
+
+// Embedded in the component that it watches, set up with frame_watchdog_init()
+typedef struct {
+  uint16_t budget_ms;
+  FrameWatchdogLevel level;
+  uint8_t overrun_frames;
+  // Set between begin and end, so an end with no matching begin is ignored
+  bool frame_is_open;
+  uint32_t frame_start_ms;
+  uint32_t level_change_ms;
+  // Number of times the level has been dropped
+  uint32_t degrade_count;
+} FrameWatchdog;
+
+void frame_watchdog_init(FrameWatchdog *watchdog, uint16_t budget_ms);
+
+// Call at the start and end of the update proc being timed
+void frame_watchdog_begin_frame(FrameWatchdog *watchdog);
+void frame_watchdog_end_frame(FrameWatchdog *watchdog);
+
+// Only reflects drawing time. Components check power_policy_is_low_power() themselves
+FrameWatchdogLevel frame_watchdog_get_level(FrameWatchdog *watchdog);
+uint32_t frame_watchdog_get_degrade_count(FrameWatchdog *watchdog);
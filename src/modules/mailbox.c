@@ -0,0 +1,26 @@
+#include "mailbox.h"
+
+void mailbox_init(Mailbox *mailbox) {
+  mailbox->value = 0;
+  mailbox->sequence = 0;
+  mailbox->taken_sequence = 0;
+}
+
+void mailbox_post(Mailbox *mailbox, int16_t value) {
+  // Only publish the new sequence once the value is in place
+  mailbox->value = value;
+  mailbox->sequence++;
+}
+
+bool mailbox_take(Mailbox *mailbox, int16_t *value) {
+  // A post landing between reading the sequence and the value only means that value is returned
+  // again by the next take
+  const uint32_t sequence = mailbox->sequence;
+  if (sequence == mailbox->taken_sequence) {
+    return false;
+  }
+
+  *value = mailbox->value;
+  mailbox->taken_sequence = sequence;
+  return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// Single-producer, single-consumer mailbox holding the newest progress value. The producer
+// overwrites the value and bumps a sequence number, the consumer takes the value whenever the
+// sequence has moved on, so neither side ever waits on the other and the newest value is never
+// lost. Values the consumer did not get to in time are simply replaced. There is nothing
+// Pebble-specific in here, so it builds and runs as-is on the host against a fake producer, see
+// test/test_mailbox.c.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+  volatile int16_t value;
+  // Bumped by the producer after each post, the consumer keeps the last one it has seen
+  volatile uint32_t sequence;
+  uint32_t taken_sequence;
+} Mailbox;
+
+void mailbox_init(Mailbox *mailbox);
+
+// Producer side. Replaces whatever value was waiting
+void mailbox_post(Mailbox *mailbox, int16_t value);
+
+// Consumer side. Returns the newest value posted since the last take, or false if nothing has been
+// posted since
+bool mailbox_take(Mailbox *mailbox, int16_t *value);
@@ -0,0 +1,31 @@
+#include "power_policy.h"
+
+static bool s_is_low_power;
+
+static void prv_battery_state_handler(BatteryChargeState state) {
+  power_policy_inject_battery_state(state);
+}
+
+void power_policy_init(void) {
+  power_policy_inject_battery_state(battery_state_service_peek());
+  battery_state_service_subscribe(prv_battery_state_handler);
+}
+
+void power_policy_deinit(void) {
+  battery_state_service_unsubscribe();
+  s_is_low_power = false;
+}
+
+bool power_policy_is_low_power(void) {
+  return s_is_low_power;
+}
+
+uint32_t power_policy_scale_interval(uint32_t interval_ms) {
+  return s_is_low_power ? interval_ms * POWER_POLICY_LOW_POWER_SCALE : interval_ms;
+}
+
+void power_policy_inject_battery_state(BatteryChargeState state) {
+  // Once it is on the charger there is no reason to hold back
+  s_is_low_power = !state.is_charging && !state.is_plugged &&
+                   (state.charge_percent <= POWER_POLICY_LOW_BATTERY_PERCENT);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <pebble.h>
+
+// App-wide low power mode, driven by battery_state_service. While the battery is low and not
+// charging, components are expected to draw fewer frames, stretch their timers and skip purely
+// decorative animation. They ask when they need to decide, so nothing has to be told about changes.
+
+// At or below this charge the app goes into low power mode
+#define POWER_POLICY_LOW_BATTERY_PERCENT 20
+// Intervals and frame times are multiplied by this in low power mode
+#define POWER_POLICY_LOW_POWER_SCALE 2
+
+// From the app's init and deinit
+void power_policy_init(void);
+void power_policy_deinit(void);
+
+bool power_policy_is_low_power(void);
+
+// Returns interval_ms, stretched in low power mode
+uint32_t power_policy_scale_interval(uint32_t interval_ms);
+
+// Applies a battery state as though battery_state_service had reported it. The service calls this
+// itself, and tests can call it directly to drive the policy without a watch
+void power_policy_inject_battery_state(BatteryChargeState state);
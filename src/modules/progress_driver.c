@@ -0,0 +1,147 @@
+#include "progress_driver.h"
+
+// Never wake up sooner than this, even if the bar is wider than the number of steps
+#define MIN_WAKEUP_INTERVAL_MS 33
+
+struct ProgressDriver {
+  ProgressLayer *progress_layer;
+
+  int16_t start_percent;
+  int16_t target_percent;
+  int16_t current_percent;
+  uint32_t start_ms;
+  uint32_t duration_ms;
+
+  ProgressDriverCompleteHandler complete_handler;
+  void *context;
+  uint32_t wakeup_count;
+};
+
+static void prv_timer_callback(void *context);
+
+static int16_t prv_get_distance(ProgressDriver *driver) {
+  return abs(driver->target_percent - driver->start_percent);
+}
+
+static int16_t prv_get_percent_at(ProgressDriver *driver, uint32_t elapsed_ms) {
+  if (elapsed_ms >= driver->duration_ms) {
+    return driver->target_percent;
+  }
+
+  const int16_t travelled = (prv_get_distance(driver) * elapsed_ms) / driver->duration_ms;
+  return (driver->target_percent > driver->start_percent) ?
+      driver->start_percent + travelled : driver->start_percent - travelled;
+}
+
+// Earliest time at which the driver reaches percent
+static uint32_t prv_get_elapsed_for_percent(ProgressDriver *driver, int16_t percent) {
+  const uint32_t distance = prv_get_distance(driver);
+  const uint32_t travelled = abs(percent - driver->start_percent);
+  return ((travelled * driver->duration_ms) + distance - 1) / distance;
+}
+
+// The first value after percent that changes what the layer shows, in the steps ProgressLayer
+// draws in for its style (pixels for a bar, segments for the ring)
+static int16_t prv_get_next_visible_percent(ProgressDriver *driver, int16_t percent) {
+  const int16_t resolution = progress_layer_get_resolution(driver->progress_layer);
+  if (resolution <= 0) {
+    return driver->target_percent;
+  }
+
+  const int16_t current_step = (percent * resolution) / 100;
+  if (driver->target_percent > percent) {
+    const int16_t next = (((current_step + 1) * 100) + resolution - 1) / resolution;
+    return (next < driver->target_percent) ? next : driver->target_percent;
+  } else {
+    if (current_step == 0) {
+      return driver->target_percent;
+    }
+    const int16_t next = ((current_step * 100) - 1) / resolution;
+    return (next > driver->target_percent) ? next : driver->target_percent;
+  }
+}
+
+static void prv_schedule_next(ProgressDriver *driver, uint32_t elapsed_ms) {
+  const int16_t next_percent = prv_get_next_visible_percent(driver, driver->current_percent);
+  const uint32_t next_elapsed_ms = prv_get_elapsed_for_percent(driver, next_percent);
+
+  uint32_t delay_ms = (next_elapsed_ms > elapsed_ms) ? next_elapsed_ms - elapsed_ms : 0;
+  const uint32_t min_delay_ms = power_policy_scale_interval(MIN_WAKEUP_INTERVAL_MS);
+  if (delay_ms < min_delay_ms) {
+    delay_ms = min_delay_ms;
+  }
+  frame_scheduler_schedule(prv_timer_callback, driver, delay_ms);
+}
+
+static void prv_timer_callback(void *context) {
+  ProgressDriver *driver = (ProgressDriver*)context;
+  driver->wakeup_count++;
+
+  const uint32_t elapsed_ms = time_util_get_ms() - driver->start_ms;
+  driver->current_percent = prv_get_percent_at(driver, elapsed_ms);
+  progress_layer_set_progress(driver->progress_layer, driver->current_percent);
+
+  if (driver->current_percent == driver->target_percent) {
+    if (driver->complete_handler) {
+      driver->complete_handler(driver, driver->context);
+    }
+    return;
+  }
+  prv_schedule_next(driver, elapsed_ms);
+}
+
+ProgressDriver* progress_driver_create(ProgressLayer *progress_layer) {
+  ProgressDriver *driver = (ProgressDriver*)malloc(sizeof(ProgressDriver));
+  if (driver) {
+    *driver = (ProgressDriver) {
+      .progress_layer = progress_layer,
+    };
+  }
+  return driver;
+}
+
+void progress_driver_destroy(ProgressDriver *driver) {
+  if (driver) {
+    progress_driver_stop(driver);
+    free(driver);
+  }
+}
+
+void progress_driver_set_complete_handler(ProgressDriver *driver, ProgressDriverCompleteHandler handler, void *context) {
+  driver->complete_handler = handler;
+  driver->context = context;
+}
+
+void progress_driver_set_progress(ProgressDriver *driver, int16_t progress_percent) {
+  progress_driver_stop(driver);
+  driver->current_percent = progress_percent;
+  progress_layer_set_progress(driver->progress_layer, progress_percent);
+}
+
+void progress_driver_run_to(ProgressDriver *driver, int16_t target_percent, uint32_t eta_ms) {
+  progress_driver_stop(driver);
+  driver->start_percent = driver->current_percent;
+  driver->target_percent = target_percent;
+  driver->start_ms = time_util_get_ms();
+  driver->duration_ms = eta_ms;
+
+  if (eta_ms == 0 || target_percent == driver->current_percent) {
+    // Nothing to animate, land on the target on the next wakeup
+    driver->duration_ms = 0;
+    frame_scheduler_schedule(prv_timer_callback, driver, 0);
+    return;
+  }
+  prv_schedule_next(driver, 0);
+}
+
+void progress_driver_run_at_rate(ProgressDriver *driver, int16_t target_percent, uint32_t ms_per_percent) {
+  progress_driver_run_to(driver, target_percent, abs(target_percent - driver->current_percent) * ms_per_percent);
+}
+
+void progress_driver_stop(ProgressDriver *driver) {
+  frame_scheduler_cancel(prv_timer_callback, driver);
+}
+
+uint32_t progress_driver_get_wakeup_count(ProgressDriver *driver) {
+  return driver->wakeup_count;
+}
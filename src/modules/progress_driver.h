@@ -0,0 +1,36 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "../layers/progress_layer.h"
+#include "frame_scheduler.h"
+#include "power_policy.h"
+#include "time_util.h"
+
+// Moves a ProgressLayer towards a target value over time. Rather than polling at a fixed rate, the
+// driver works out from the layer's resolution (pixels of bar, or segments of ring) when the next
+// step will change and only wakes up then, so a slow operation on a narrow bar costs a handful of
+// wakeups instead of 30 a second.
+
+typedef struct ProgressDriver ProgressDriver;
+
+typedef void (*ProgressDriverCompleteHandler)(ProgressDriver *driver, void *context);
+
+ProgressDriver* progress_driver_create(ProgressLayer *progress_layer);
+void progress_driver_destroy(ProgressDriver *driver);
+
+void progress_driver_set_complete_handler(ProgressDriver *driver, ProgressDriverCompleteHandler handler, void *context);
+
+// Jumps straight to progress_percent, stopping any run in progress
+void progress_driver_set_progress(ProgressDriver *driver, int16_t progress_percent);
+
+// Moves from the current value to target_percent so that it arrives in eta_ms
+void progress_driver_run_to(ProgressDriver *driver, int16_t target_percent, uint32_t eta_ms);
+
+// Moves from the current value to target_percent, taking ms_per_percent for each percent
+void progress_driver_run_at_rate(ProgressDriver *driver, int16_t target_percent, uint32_t ms_per_percent);
+
+void progress_driver_stop(ProgressDriver *driver);
+
+// Number of times the driver has woken up to update the layer
+uint32_t progress_driver_get_wakeup_count(ProgressDriver *driver);
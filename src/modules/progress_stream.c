@@ -0,0 +1,52 @@
+#include "progress_stream.h"
+
+struct ProgressStream {
+  ProgressLayer *progress_layer;
+  Mailbox mailbox;
+  // Set while there are values waiting to be applied on the next frame
+  bool is_frame_pending;
+  uint32_t apply_count;
+};
+
+static void prv_frame_callback(void *context) {
+  ProgressStream *stream = (ProgressStream *)context;
+  stream->is_frame_pending = false;
+
+  int16_t progress_percent;
+  if (mailbox_take(&stream->mailbox, &progress_percent)) {
+    progress_layer_set_progress(stream->progress_layer, progress_percent);
+    stream->apply_count++;
+  }
+}
+
+ProgressStream* progress_stream_create(ProgressLayer *progress_layer) {
+  ProgressStream *stream = (ProgressStream *)malloc(sizeof(ProgressStream));
+  if (!stream) {
+    return NULL;
+  }
+
+  stream->progress_layer = progress_layer;
+  mailbox_init(&stream->mailbox);
+  stream->is_frame_pending = false;
+  stream->apply_count = 0;
+  return stream;
+}
+
+void progress_stream_destroy(ProgressStream *stream) {
+  if (stream) {
+    frame_scheduler_cancel(prv_frame_callback, stream);
+    free(stream);
+  }
+}
+
+void progress_stream_push(ProgressStream *stream, int16_t progress_percent) {
+  mailbox_post(&stream->mailbox, progress_percent);
+  // Only the newest value pushed before the next frame is applied
+  if (!stream->is_frame_pending) {
+    stream->is_frame_pending = frame_scheduler_schedule(prv_frame_callback, stream, FRAME_SCHEDULER_FRAME_MS);
+  }
+}
+
+uint32_t progress_stream_get_apply_count(ProgressStream *stream) {
+  return stream->apply_count;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "../layers/progress_layer.h"
+#include "frame_scheduler.h"
+#include "mailbox.h"
+
+// Feeds a ProgressLayer from a producer such as AppMessage or the background worker. The producer
+// pushes as often as it likes, and once per frame the stream takes the newest value and drops the
+// rest, so a burst of updates costs at most one redraw per frame.
+
+typedef struct ProgressStream ProgressStream;
+
+ProgressStream* progress_stream_create(ProgressLayer *progress_layer);
+void progress_stream_destroy(ProgressStream *stream);
+
+// Never blocks. A value not yet applied when the next one arrives is replaced by it
+void progress_stream_push(ProgressStream *stream, int16_t progress_percent);
+
+// Number of frames in which a value was applied to the layer
+uint32_t progress_stream_get_apply_count(ProgressStream *stream);
@@ -0,0 +1,131 @@
+#include "text_change_animation.h"
+
+typedef enum {
+  TextChangeAnimationPhaseIdle,
+  TextChangeAnimationPhaseOut,
+  TextChangeAnimationPhaseIn,
+} TextChangeAnimationPhase;
+
+struct TextChangeAnimation {
+  Layer *layer;
+  GRect rest_frame;
+  int16_t distance_px;
+  uint32_t half_duration_ms;
+
+  TextChangeAnimationPhase phase;
+  uint32_t phase_start_ms;
+
+  TextChangeAnimationSwapHandler swap_handler;
+  void *context;
+};
+
+// Moves the layer left of its rest frame by distance_px scaled by progress, which may be negative
+static void prv_set_offset(TextChangeAnimation *animation, AnimationProgress progress) {
+  GRect frame = animation->rest_frame;
+  frame.origin.x -= (animation->distance_px * progress) / ANIMATION_NORMALIZED_MAX;
+  layer_set_frame(animation->layer, frame);
+}
+
+static void prv_swap_text(TextChangeAnimation *animation) {
+  if (animation->swap_handler) {
+    animation->swap_handler(animation, animation->context);
+  }
+}
+
+static void prv_tick(void *context);
+
+static void prv_schedule_tick(TextChangeAnimation *animation) {
+  if (!frame_scheduler_schedule(prv_tick, animation, FRAME_SCHEDULER_FRAME_MS)) {
+    // No frame will come to move the layer, so swap the text and put it back at rest now
+    text_change_animation_finish(animation);
+  }
+}
+
+static void prv_tick(void *context) {
+  TextChangeAnimation *animation = (TextChangeAnimation *)context;
+  const uint32_t now_ms = time_util_get_ms();
+  uint32_t elapsed_ms = now_ms - animation->phase_start_ms;
+
+  if (animation->phase == TextChangeAnimationPhaseOut) {
+    if (elapsed_ms < animation->half_duration_ms) {
+      const AnimationProgress progress = (elapsed_ms * ANIMATION_NORMALIZED_MAX) / animation->half_duration_ms;
+      prv_set_offset(animation, easing_apply(EasingCurveEaseInOut, progress));
+      prv_schedule_tick(animation);
+      return;
+    }
+    prv_swap_text(animation);
+    animation->phase = TextChangeAnimationPhaseIn;
+    animation->phase_start_ms += animation->half_duration_ms;
+    elapsed_ms -= animation->half_duration_ms;
+  }
+
+  if (elapsed_ms < animation->half_duration_ms) {
+    // Comes back in from the right, overshooting the rest frame on the way
+    const AnimationProgress progress = (elapsed_ms * ANIMATION_NORMALIZED_MAX) / animation->half_duration_ms;
+    prv_set_offset(animation, easing_apply(EasingCurveOvershoot, progress) - ANIMATION_NORMALIZED_MAX);
+    prv_schedule_tick(animation);
+    return;
+  }
+
+  layer_set_frame(animation->layer, animation->rest_frame);
+  animation->phase = TextChangeAnimationPhaseIdle;
+}
+
+TextChangeAnimation* text_change_animation_create(Layer *layer, GRect rest_frame, int16_t distance_px,
+                                                  uint32_t half_duration_ms) {
+  TextChangeAnimation *animation = (TextChangeAnimation *)malloc(sizeof(TextChangeAnimation));
+  if (animation) {
+    *animation = (TextChangeAnimation) {
+      .layer = layer,
+      .rest_frame = rest_frame,
+      .distance_px = distance_px,
+      .half_duration_ms = half_duration_ms ? half_duration_ms : 1,
+      .phase = TextChangeAnimationPhaseIdle,
+    };
+  }
+  return animation;
+}
+
+void text_change_animation_destroy(TextChangeAnimation *animation) {
+  if (animation) {
+    frame_scheduler_cancel(prv_tick, animation);
+    free(animation);
+  }
+}
+
+void text_change_animation_set_swap_handler(TextChangeAnimation *animation,
+                                            TextChangeAnimationSwapHandler handler, void *context) {
+  animation->swap_handler = handler;
+  animation->context = context;
+}
+
+void text_change_animation_start(TextChangeAnimation *animation) {
+  if (animation->phase != TextChangeAnimationPhaseIdle) {
+    return;
+  }
+  if (power_policy_is_low_power()) {
+    prv_swap_text(animation);
+    return;
+  }
+
+  animation->phase = TextChangeAnimationPhaseOut;
+  animation->phase_start_ms = time_util_get_ms();
+  prv_schedule_tick(animation);
+}
+
+void text_change_animation_finish(TextChangeAnimation *animation) {
+  if (animation->phase == TextChangeAnimationPhaseIdle) {
+    return;
+  }
+
+  frame_scheduler_cancel(prv_tick, animation);
+  if (animation->phase == TextChangeAnimationPhaseOut) {
+    prv_swap_text(animation);
+  }
+  layer_set_frame(animation->layer, animation->rest_frame);
+  animation->phase = TextChangeAnimationPhaseIdle;
+}
+
+bool text_change_animation_is_running(TextChangeAnimation *animation) {
+  return animation->phase != TextChangeAnimationPhaseIdle;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "easing.h"
+#include "frame_scheduler.h"
+#include "power_policy.h"
+#include "time_util.h"
+
+// Shakes a layer to show its text changing. The layer eases out to the left, the text is swapped
+// and it overshoots back in from the right. The component is allocated once and each run only
+// resets its start time; the frames come from the frame scheduler rather than from Animations,
+// which the system would free at the end of every run. In low power mode the shake is skipped and
+// the text is just swapped.
+
+typedef struct TextChangeAnimation TextChangeAnimation;
+
+// Called once the layer is furthest out, to change its text
+typedef void (*TextChangeAnimationSwapHandler)(TextChangeAnimation *animation, void *context);
+
+// rest_frame is where the layer sits between runs, each half of the shake takes half_duration_ms
+TextChangeAnimation* text_change_animation_create(Layer *layer, GRect rest_frame, int16_t distance_px,
+                                                  uint32_t half_duration_ms);
+void text_change_animation_destroy(TextChangeAnimation *animation);
+
+void text_change_animation_set_swap_handler(TextChangeAnimation *animation,
+                                            TextChangeAnimationSwapHandler handler, void *context);
+
+// Starts a run, from the rest frame. Does nothing if a run is already in progress
+void text_change_animation_start(TextChangeAnimation *animation);
+// Jumps to the end of the run in progress, swapping the text if that has not happened yet
+void text_change_animation_finish(TextChangeAnimation *animation);
+bool text_change_animation_is_running(TextChangeAnimation *animation);
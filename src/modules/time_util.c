@@ -0,0 +1,8 @@
+#include "time_util.h"
+
+uint32_t time_util_get_ms(void) {
+  time_t seconds;
+  uint16_t milliseconds;
+  time_ms(&seconds, &milliseconds);
+  return ((uint32_t)seconds * 1000) + milliseconds;
+}
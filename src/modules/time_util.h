@@ -0,0 +1,7 @@
+#pragma once
+
+#include <pebble.h>
+
+// Milliseconds since the epoch, truncated to 32 bits. Only differences between two values are
+// meaningful, and they stay correct across the wrap as long as they are taken as uint32_t.
+uint32_t time_util_get_ms(void);
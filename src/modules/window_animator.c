@@ -0,0 +1,118 @@
+#include "window_animator.h"
+
+typedef struct {
+  Animation *animation;
+  AnimationHandlers handlers;
+  void *context;
+} WindowAnimatorSlot;
+
+struct WindowAnimator {
+  bool is_suspended;
+  uint8_t num_animations;
+  // Kept packed, the first num_animations entries are in use
+  WindowAnimatorSlot slots[WINDOW_ANIMATOR_MAX_ANIMATIONS];
+};
+
+static int prv_find_slot(WindowAnimator *animator, Animation *animation) {
+  for (int i = 0; i < animator->num_animations; i++) {
+    if (animator->slots[i].animation == animation) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void prv_started_handler(Animation *animation, void *context) {
+  WindowAnimator *animator = (WindowAnimator *)context;
+  const int index = prv_find_slot(animator, animation);
+  if (index >= 0 && animator->slots[index].handlers.started) {
+    animator->slots[index].handlers.started(animation, animator->slots[index].context);
+  }
+}
+
+static void prv_stopped_handler(Animation *animation, bool finished, void *context) {
+  WindowAnimator *animator = (WindowAnimator *)context;
+  const int index = prv_find_slot(animator, animation);
+  if (index < 0) {
+    return;
+  }
+
+  // Untrack first, the handler may well schedule the next animation
+  const WindowAnimatorSlot slot = animator->slots[index];
+  animator->slots[index] = animator->slots[--animator->num_animations];
+  if (slot.handlers.stopped) {
+    slot.handlers.stopped(animation, finished, slot.context);
+  }
+}
+
+static void prv_unschedule_all(WindowAnimator *animator) {
+  while (animator->num_animations > 0) {
+    const uint8_t num_animations = animator->num_animations;
+    Animation *animation = animator->slots[num_animations - 1].animation;
+    animation_unschedule(animation);
+    // The stopped handler normally untracks it, but make sure this always moves on
+    if (animator->num_animations == num_animations &&
+        animator->slots[num_animations - 1].animation == animation) {
+      animator->num_animations--;
+    }
+  }
+}
+
+WindowAnimator* window_animator_create(void) {
+  WindowAnimator *animator = (WindowAnimator *)malloc(sizeof(WindowAnimator));
+  if (animator) {
+    *animator = (WindowAnimator) {
+      .is_suspended = false,
+    };
+  }
+  return animator;
+}
+
+void window_animator_destroy(WindowAnimator *animator) {
+  if (animator) {
+    animator->is_suspended = true;
+    prv_unschedule_all(animator);
+    free(animator);
+  }
+}
+
+bool window_animator_schedule(WindowAnimator *animator, Animation *animation, AnimationHandlers handlers,
+                              void *context) {
+  if (animator->is_suspended) {
+    animation_destroy(animation);
+    return false;
+  }
+
+  if (animator->num_animations >= WINDOW_ANIMATOR_MAX_ANIMATIONS) {
+    // Still run it, it just won't be stopped when the window disappears
+    APP_LOG(APP_LOG_LEVEL_WARNING, "WindowAnimator is full, animation not tracked");
+    animation_set_handlers(animation, handlers, context);
+    animation_schedule(animation);
+    return true;
+  }
+
+  animator->slots[animator->num_animations++] = (WindowAnimatorSlot) {
+    .animation = animation,
+    .handlers = handlers,
+    .context = context,
+  };
+  animation_set_handlers(animation, (AnimationHandlers) {
+    .started = prv_started_handler,
+    .stopped = prv_stopped_handler,
+  }, animator);
+  animation_schedule(animation);
+  return true;
+}
+
+void window_animator_suspend(WindowAnimator *animator) {
+  animator->is_suspended = true;
+  prv_unschedule_all(animator);
+}
+
+void window_animator_resume(WindowAnimator *animator) {
+  animator->is_suspended = false;
+}
+
+bool window_animator_is_suspended(WindowAnimator *animator) {
+  return animator->is_suspended;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <pebble.h>
+
+// Keeps track of the animations a window has running so they can all be stopped when the window
+// disappears, leaving a hidden window with nothing to animate or redraw. Tracked animations are
+// unscheduled on suspend and their stopped handlers are called with finished set to false. A
+// handler that sees window_animator_is_suspended() should jump straight to its end state rather
+// than starting another animation. The window starts its animations again on appear.
+
+#define WINDOW_ANIMATOR_MAX_ANIMATIONS 4
+
+typedef struct WindowAnimator WindowAnimator;
+
+WindowAnimator* window_animator_create(void);
+// Unschedules anything still running, so call it before destroying the layers being animated
+void window_animator_destroy(WindowAnimator *animator);
+
+// Schedules the animation and tracks it until it stops, calling handlers as usual. While the
+// animator is suspended the animation is destroyed instead and false is returned
+bool window_animator_schedule(WindowAnimator *animator, Animation *animation, AnimationHandlers handlers,
+                              void *context);
+
+// From the window's disappear handler
+void window_animator_suspend(WindowAnimator *animator);
+// From the window's appear handler
+void window_animator_resume(WindowAnimator *animator);
+bool window_animator_is_suspended(WindowAnimator *animator);
@@ -6,9 +6,15 @@
 
 static Window *s_main_window;
 static TextLayer *s_label_layer;
-static Layer *s_background_layer, *s_icon_layer;
+static Layer *s_background_layer, *s_icon_layer, *s_frame_end_layer;
 
 static Animation *s_appear_anim = NULL;
+static WindowAnimator *s_animator;
+// Times the background, icon and label, the layers that move during the appear animation
+static FrameWatchdog s_watchdog;
+// Where the appear animation leaves the layers, and the watchdog level it was built for
+static GRect s_background_finish, s_icon_finish, s_label_finish;
+static FrameWatchdogLevel s_appear_level;
 
 static GBitmap *s_icon_bitmap;
 
@@ -16,7 +22,21 @@ static void anim_stopped_handler(Animation *animation, bool finished, void *cont
   s_appear_anim = NULL;
 }
 
+static void set_finish_frames(void) {
+  layer_set_frame(s_background_layer, s_background_finish);
+  layer_set_frame(s_icon_layer, s_icon_finish);
+  layer_set_frame(text_layer_get_layer(s_label_layer), s_label_finish);
+}
+
+static void jump_to_end(void *context) {
+  if (s_appear_anim) {
+    animation_unschedule(s_appear_anim);
+  }
+  set_finish_frames();
+}
+
 static void background_update_proc(Layer *layer, GContext *ctx) {
+  frame_watchdog_begin_frame(&s_watchdog);
   graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(GColorYellow, GColorWhite));
   graphics_fill_rect(ctx, layer_get_bounds(layer), 0, 0);
 }
@@ -28,6 +48,17 @@ static void icon_update_proc(Layer *layer, GContext *ctx) {
   graphics_draw_bitmap_in_rect(ctx, s_icon_bitmap, (GRect){.origin = bounds.origin, .size = bitmap_bounds.size});
 }
 
+// Drawn last and draws nothing, so the frame is timed through the label as well
+static void frame_end_update_proc(Layer *layer, GContext *ctx) {
+  frame_watchdog_end_frame(&s_watchdog);
+
+  // Drawing fell behind while the layers are moving, land them now rather than on the next appear.
+  // Frames can't be changed in the middle of drawing, so it happens on the next frame
+  if (s_appear_anim && frame_watchdog_get_level(&s_watchdog) > s_appear_level) {
+    frame_scheduler_schedule(jump_to_end, NULL, 0);
+  }
+}
+
 static void window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
@@ -53,11 +84,22 @@ static void window_load(Window *window) {
   text_layer_set_text_alignment(s_label_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
   text_layer_set_font(s_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
   layer_add_child(window_layer, text_layer_get_layer(s_label_layer));
+
+  s_frame_end_layer = layer_create(bounds);
+  layer_set_update_proc(s_frame_end_layer, frame_end_update_proc);
+  layer_add_child(window_layer, s_frame_end_layer);
+
+  s_animator = window_animator_create();
+  frame_watchdog_init(&s_watchdog, DIALOG_MESSAGE_WINDOW_FRAME_BUDGET);
 }
 
 static void window_unload(Window *window) {
+  window_animator_destroy(s_animator);
+  frame_scheduler_cancel(jump_to_end, NULL);
+
   layer_destroy(s_background_layer);
   layer_destroy(s_icon_layer);
+  layer_destroy(s_frame_end_layer);
 
   text_layer_destroy(s_label_layer);
 
@@ -68,6 +110,9 @@ static void window_unload(Window *window) {
 }
 
 static void window_appear(Window *window) {
+  // Anything cut short when the window disappeared carries on from wherever the layers were left
+  window_animator_resume(s_animator);
+
   if(s_appear_anim) {
      // In progress, cancel
     animation_unschedule(s_appear_anim);
@@ -78,30 +123,53 @@ static void window_appear(Window *window) {
 
   Layer *label_layer = text_layer_get_layer(s_label_layer);
 
-  GRect start = layer_get_frame(s_background_layer);
-  GRect finish = bounds;
-  Animation *background_anim = (Animation*)property_animation_create_layer_frame(s_background_layer, &start, &finish);
-
-  start = layer_get_frame(s_icon_layer);
+  s_background_finish = bounds;
   const GEdgeInsets icon_insets = {
     .top = DIALOG_MESSAGE_WINDOW_MARGIN,
     .left = PBL_IF_ROUND_ELSE((bounds.size.w - bitmap_bounds.size.w) / 2, DIALOG_MESSAGE_WINDOW_MARGIN)};
-  finish = grect_inset(bounds, icon_insets);
-  Animation *icon_anim = (Animation*)property_animation_create_layer_frame(s_icon_layer, &start, &finish);
-
-  start = layer_get_frame(label_layer);
+  s_icon_finish = grect_inset(bounds, icon_insets);
   const GEdgeInsets finish_insets = {
     .top = DIALOG_MESSAGE_WINDOW_MARGIN + bitmap_bounds.size.h + 5 /* small adjustment */,
     .right = DIALOG_MESSAGE_WINDOW_MARGIN, .left = DIALOG_MESSAGE_WINDOW_MARGIN};
-  finish = grect_inset(bounds, finish_insets);
-  Animation *label_anim = (Animation*)property_animation_create_layer_frame(label_layer, &start, &finish);
+  s_label_finish = grect_inset(bounds, finish_insets);
+
+  // If drawing is already behind, make this appear cheaper. A drop while it runs lands it early,
+  // see frame_end_update_proc()
+  const FrameWatchdogLevel level = frame_watchdog_get_level(&s_watchdog);
+  s_appear_level = level;
+  if (level >= FrameWatchdogLevelJumpToEnd) {
+    set_finish_frames();
+    return;
+  }
+  const int speed_shift = (level >= FrameWatchdogLevelShort) ? 1 : 0;
+  const uint32_t duration = DIALOG_MESSAGE_WINDOW_APPEAR_DURATION >> speed_shift;
+
+  GRect start = layer_get_frame(s_background_layer);
+  Animation *background_anim = (Animation*)property_animation_create_layer_frame(s_background_layer, &start, &s_background_finish);
+  animation_set_custom_curve(background_anim, easing_curve_ease_in_out);
+  animation_set_duration(background_anim, duration);
+
+  start = layer_get_frame(s_icon_layer);
+  Animation *icon_anim = (Animation*)property_animation_create_layer_frame(s_icon_layer, &start, &s_icon_finish);
+  // The overshoot is decoration, dropped when drawing is slow or the battery is low
+  const bool skip_overshoot = (level >= FrameWatchdogLevelNoSettle) || power_policy_is_low_power();
+  animation_set_custom_curve(icon_anim, skip_overshoot ? easing_curve_ease_in_out : easing_curve_overshoot);
+  animation_set_duration(icon_anim, duration);
+
+  start = layer_get_frame(label_layer);
+  Animation *label_anim = (Animation*)property_animation_create_layer_frame(label_layer, &start, &s_label_finish);
+  animation_set_custom_curve(label_anim, easing_curve_ease_in_out);
+  animation_set_duration(label_anim, duration);
 
   s_appear_anim = animation_spawn_create(background_anim, icon_anim, label_anim, NULL);
-  animation_set_handlers(s_appear_anim, (AnimationHandlers) {
+  animation_set_delay(s_appear_anim, DIALOG_MESSAGE_WINDOW_APPEAR_DELAY >> speed_shift);
+  window_animator_schedule(s_animator, s_appear_anim, (AnimationHandlers) {
     .stopped = anim_stopped_handler
   }, NULL);
-  animation_set_delay(s_appear_anim, 700);
-  animation_schedule(s_appear_anim);
+}
+
+static void window_disappear(Window *window) {
+  window_animator_suspend(s_animator);
 }
 
 void dialog_message_window_push() {
@@ -111,7 +179,8 @@ void dialog_message_window_push() {
     window_set_window_handlers(s_main_window, (WindowHandlers) {
         .load = window_load,
         .unload = window_unload,
-        .appear = window_appear
+        .appear = window_appear,
+        .disappear = window_disappear
     });
   }
   window_stack_push(s_main_window, true);
@@ -2,7 +2,16 @@
 
 #include <pebble.h>
 
+#include "../modules/easing.h"
+#include "../modules/frame_scheduler.h"
+#include "../modules/frame_watchdog.h"
+#include "../modules/power_policy.h"
+#include "../modules/window_animator.h"
+
 #define DIALOG_MESSAGE_WINDOW_MESSAGE  "Battery is low! Connect the charger."
 #define DIALOG_MESSAGE_WINDOW_MARGIN   10
+#define DIALOG_MESSAGE_WINDOW_APPEAR_DELAY    700
+#define DIALOG_MESSAGE_WINDOW_APPEAR_DURATION 250
+#define DIALOG_MESSAGE_WINDOW_FRAME_BUDGET    15 // Milliseconds to draw the background, icon and label
 
 void dialog_message_window_push();
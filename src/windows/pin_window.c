@@ -17,19 +17,16 @@ static void selection_handle_complete(void *context) {
   pin_window->callbacks.pin_complete(pin_window->pin, pin_window);
 }
 
-static void selection_handle_inc(int index, uint8_t clicks, void *context) {
+static void selection_handle_inc(int index, uint16_t count, void *context) {
   PinWindow *pin_window = (PinWindow*)context;
-  pin_window->pin.digits[index]++;
-  if(pin_window->pin.digits[index] > PIN_WINDOW_MAX_VALUE) {
-    pin_window->pin.digits[index] = 0;
-  }
+  pin_window->pin.digits[index] = (pin_window->pin.digits[index] + count) % (PIN_WINDOW_MAX_VALUE + 1);
 }
 
-static void selection_handle_dec(int index, uint8_t clicks, void *context) {
+static void selection_handle_dec(int index, uint16_t count, void *context) {
   PinWindow *pin_window = (PinWindow*)context;
-  pin_window->pin.digits[index]--;
+  pin_window->pin.digits[index] -= count % (PIN_WINDOW_MAX_VALUE + 1);
   if(pin_window->pin.digits[index] < 0) {
-    pin_window->pin.digits[index] = PIN_WINDOW_MAX_VALUE;
+    pin_window->pin.digits[index] += PIN_WINDOW_MAX_VALUE + 1;
   }
 }
 
@@ -82,6 +79,7 @@ PinWindow* pin_window_create(PinWindowCallbacks callbacks) {
         .increment = selection_handle_inc,
         .decrement = selection_handle_dec,
       });
+      selection_layer_set_cache_cell_text(pin_window->selection, true);
       layer_add_child(window_get_root_layer(pin_window->window), pin_window->selection);
 
       // Create status bar
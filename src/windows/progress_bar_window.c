@@ -5,35 +5,22 @@
 #include "progress_bar_window.h"
 
 static Window *s_window;
-static Layer *s_progress_bar;
+static ProgressLayer *s_progress_bar;
 static StatusBarLayer *s_status_bar;
 
-static AppTimer *s_timer;
-static int s_progress = 0;  // 0 - 100
+static ProgressDriver *s_progress_driver;
 
-static void progress_callback(void *context);
-
-static void progress_bar_proc(Layer *layer, GContext *ctx) {
-  GRect bounds = layer_get_bounds(layer);
-
-  int width = (int)(float)(((float)s_progress / 100.0F) * bounds.size.w);
-  graphics_context_set_stroke_color(ctx, GColorWhite);
-  graphics_draw_line(ctx, GPointZero, GPoint(width, 0));
-}
-
-static void next_timer() {
-  s_timer = app_timer_register(PROGRESS_BAR_WINDOW_DELTA, progress_callback, NULL);
+static void restart_progress() {
+  progress_driver_set_progress(s_progress_driver, 0);
+  progress_driver_run_to(s_progress_driver, 100, PROGRESS_BAR_WINDOW_DURATION);
 }
 
-static void progress_callback(void *context) {
-  s_progress += (s_progress < 100) ? 1 : -100;
-  layer_mark_dirty(s_progress_bar);
-  next_timer();
+static void progress_complete_handler(ProgressDriver *driver, void *context) {
+  restart_progress();
 }
 
 static void window_appear(Window *window) {
-  s_progress = 0;
-  next_timer();
+  restart_progress();
 }
 
 static void window_load(Window *window) {
@@ -44,26 +31,28 @@ static void window_load(Window *window) {
   status_bar_layer_set_colors(s_status_bar, GColorClear, GColorWhite);
   layer_add_child(window_layer, status_bar_layer_get_layer(s_status_bar));
 
-  s_progress_bar = layer_create((GRect){
+  s_progress_bar = progress_layer_create((GRect){
     .origin = GPoint(0, STATUS_BAR_LAYER_HEIGHT - 2),
     .size = PROGRESS_BAR_WINDOW_SIZE
   });
-  layer_set_update_proc(s_progress_bar, progress_bar_proc);
+  progress_layer_set_style(s_progress_bar, ProgressLayerStyleLine);
+  progress_layer_set_foreground_color(s_progress_bar, GColorWhite);
   layer_add_child(window_layer, s_progress_bar);
+
+  s_progress_driver = progress_driver_create(s_progress_bar);
+  progress_driver_set_complete_handler(s_progress_driver, progress_complete_handler, NULL);
 }
 
 static void window_unload(Window *window) {
-  layer_destroy(s_progress_bar);
+  progress_driver_destroy(s_progress_driver);
+  progress_layer_destroy(s_progress_bar);
   status_bar_layer_destroy(s_status_bar);
   window_destroy(s_window);
   s_window = NULL;
 }
 
 static void window_disappear(Window *window) {
-  if(s_timer) {
-    app_timer_cancel(s_timer);
-    s_timer = NULL;
-  }
+  progress_driver_stop(s_progress_driver);
 }
 
 void progress_bar_window_push() {
@@ -2,7 +2,10 @@
 
 #include <pebble.h>
 
+#include "../layers/progress_layer.h"
+#include "../modules/progress_driver.h"
+
 #define PROGRESS_BAR_WINDOW_SIZE GSize(144, 1) // System default
-#define PROGRESS_BAR_WINDOW_DELTA 33
+#define PROGRESS_BAR_WINDOW_DURATION 3300 // Time to go from 0 to 100%
 
 void progress_bar_window_push();
\ No newline at end of file
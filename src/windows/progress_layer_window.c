@@ -2,35 +2,39 @@
 
 static Window *s_window;
 static ProgressLayer *s_progress_layer;
+static ProgressDriver *s_progress_driver;
 
-static AppTimer *s_timer;
-static int s_progress;
-
-static void progress_callback(void *context);
-
-static void next_timer() {
-  s_timer = app_timer_register(PROGRESS_LAYER_WINDOW_DELTA, progress_callback, NULL);
+static void restart_progress() {
+  progress_driver_set_progress(s_progress_driver, 0);
+  progress_driver_run_to(s_progress_driver, 100, PROGRESS_LAYER_WINDOW_DURATION);
 }
 
-static void progress_callback(void *context) {
-  s_progress += (s_progress < 100) ? 1 : -100;
-  progress_layer_set_progress(s_progress_layer, s_progress);
-  next_timer();
+static void progress_complete_handler(ProgressDriver *driver, void *context) {
+  restart_progress();
 }
 
 static void window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
 
+#if defined(PBL_ROUND)
+  s_progress_layer = progress_layer_create(grect_inset(bounds, GEdgeInsets(PROGRESS_LAYER_WINDOW_RING_INSET)));
+  progress_layer_set_style(s_progress_layer, ProgressLayerStyleRadial);
+#else
   s_progress_layer = progress_layer_create(GRect((bounds.size.w - PROGRESS_LAYER_WINDOW_WIDTH) / 2, 80, PROGRESS_LAYER_WINDOW_WIDTH, 6));
+#endif
   progress_layer_set_progress(s_progress_layer, 0);
   progress_layer_set_corner_radius(s_progress_layer, 2);
   progress_layer_set_foreground_color(s_progress_layer, GColorWhite);
   progress_layer_set_background_color(s_progress_layer, GColorBlack);
   layer_add_child(window_layer, s_progress_layer);
+
+  s_progress_driver = progress_driver_create(s_progress_layer);
+  progress_driver_set_complete_handler(s_progress_driver, progress_complete_handler, NULL);
 }
 
 static void window_unload(Window *window) {
+  progress_driver_destroy(s_progress_driver);
   progress_layer_destroy(s_progress_layer);
 
   window_destroy(window);
@@ -38,15 +42,11 @@ static void window_unload(Window *window) {
 }
 
 static void window_appear(Window *window) {
-  s_progress = 0;
-  next_timer();
+  restart_progress();
 }
 
 static void window_disappear(Window *window) {
-  if(s_timer) {
-    app_timer_cancel(s_timer);
-    s_timer = NULL;
-  }
+  progress_driver_stop(s_progress_driver);
 }
 
 void progress_layer_window_push() {
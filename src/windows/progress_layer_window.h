@@ -3,8 +3,10 @@
 #include <pebble.h>
 
 #include "../layers/progress_layer.h"
+#include "../modules/progress_driver.h"
 
-#define PROGRESS_LAYER_WINDOW_DELTA 33
+#define PROGRESS_LAYER_WINDOW_DURATION 3300 // Time to go from 0 to 100%
 #define PROGRESS_LAYER_WINDOW_WIDTH 80
+#define PROGRESS_LAYER_WINDOW_RING_INSET 10 // Gap between the ring and the edge of a round screen
 
 void progress_layer_window_push();
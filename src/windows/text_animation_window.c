@@ -5,43 +5,17 @@
 #include "text_animation_window.h"
 
 static Window *s_window;
-static TextLayer *s_text_layer;
+static CachedTextLayer *s_text_layer;
+static TextChangeAnimation *s_text_change_animation;
 
-static AppTimer *s_timer;
 static char s_text[2][32];
 static uint8_t s_current_text;
 
 static void animate();
 
-static void out_stopped_handler(Animation *animation, bool finished, void *context) {
+static void swap_text_handler(TextChangeAnimation *animation, void *context) {
   s_current_text += (s_current_text == 0) ? 1 : -1;
-  text_layer_set_text(s_text_layer, s_text[s_current_text]);
-
-  Layer *text_layer = text_layer_get_layer(s_text_layer);
-  GRect frame = layer_get_frame(text_layer);
-  GRect start = GRect(frame.origin.x + (2 * TEXT_ANIMATION_WINDOW_DISTANCE), frame.origin.y, frame.size.w, frame.size.h);
-  GRect finish = GRect(frame.origin.x + TEXT_ANIMATION_WINDOW_DISTANCE, frame.origin.y, frame.size.w, frame.size.h);
-
-  PropertyAnimation *in_prop_anim = property_animation_create_layer_frame(text_layer, &start, &finish);
-  Animation *in_anim = property_animation_get_animation(in_prop_anim);
-  animation_set_curve(in_anim, AnimationCurveEaseInOut);
-  animation_set_duration(in_anim, TEXT_ANIMATION_WINDOW_DURATION);
-  animation_schedule(in_anim);
-}
-
-static void shake_animation() {
-  Layer *text_layer = text_layer_get_layer(s_text_layer);
-  GRect start = layer_get_frame(text_layer);
-  GRect finish = GRect(start.origin.x - TEXT_ANIMATION_WINDOW_DISTANCE, start.origin.y, start.size.w, start.size.h);
-
-  PropertyAnimation *out_prop_anim = property_animation_create_layer_frame(text_layer, &start, &finish);
-  Animation *out_anim = property_animation_get_animation(out_prop_anim);
-  animation_set_curve(out_anim, AnimationCurveEaseInOut);
-  animation_set_duration(out_anim, TEXT_ANIMATION_WINDOW_DURATION);
-  animation_set_handlers(out_anim, (AnimationHandlers) {
-    .stopped = out_stopped_handler
-  }, NULL);
-  animation_schedule(out_anim);
+  cached_text_layer_set_text(s_text_layer, s_text[s_current_text]);
 }
 
 static void animate_callback(void *context) {
@@ -49,35 +23,77 @@ static void animate_callback(void *context) {
 }
 
 static void animate() {
-  shake_animation();
-  s_timer = app_timer_register(TEXT_ANIMATION_WINDOW_INTERVAL, animate_callback, NULL);
+  text_change_animation_start(s_text_change_animation);
+  frame_scheduler_schedule(animate_callback, NULL, power_policy_scale_interval(TEXT_ANIMATION_WINDOW_INTERVAL));
+}
+
+#ifdef PBL_ROUND
+// Columns the round display cuts off at each end of the row of frame furthest from its centre
+static int16_t get_round_inset(GRect bounds, GRect frame) {
+  const int32_t radius = bounds.size.w / 2;
+  const int32_t center_y = bounds.origin.y + (bounds.size.h / 2);
+  const int32_t above = center_y - frame.origin.y;
+  const int32_t below = frame.origin.y + frame.size.h - center_y;
+  const int32_t dy = (above > below) ? above : below;
+
+  int32_t half_width = 0;
+  while ((half_width + 1) * (half_width + 1) <= (radius * radius) - (dy * dy)) {
+    half_width++;
+  }
+  // One more for the rounding of the display's edge
+  return radius - half_width + 1;
+}
+#endif
+
+// The text layer caches its text only while it is fully on screen, so it is inset by the furthest
+// the shake moves it and kept clear of a round display's edge, leaving the cache in use throughout
+static GRect get_text_frame(GRect bounds) {
+  // Only as tall as the text, the layer keeps a bitmap of its whole frame
+  GRect frame = GRect(bounds.origin.x, (bounds.size.h / 2) - 24, bounds.size.w, TEXT_ANIMATION_WINDOW_TEXT_HEIGHT);
+  int16_t inset = TEXT_ANIMATION_WINDOW_DISTANCE + TEXT_ANIMATION_WINDOW_OVERSHOOT;
+#ifdef PBL_ROUND
+  inset += get_round_inset(bounds, frame);
+#endif
+  frame.origin.x += inset;
+  frame.size.w -= 2 * inset;
+  return frame;
 }
 
 static void window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
 
-  const GEdgeInsets text_insets = {.top = (bounds.size.h / 2) - 24};
-  s_text_layer = text_layer_create(grect_inset(bounds, text_insets));
-  text_layer_set_text(s_text_layer, "Example text.");
-  text_layer_set_text_color(s_text_layer, GColorWhite);
-  text_layer_set_background_color(s_text_layer, GColorClear);
-  text_layer_set_font(s_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_text_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_text_layer));
+  const GRect text_frame = get_text_frame(bounds);
+  s_text_layer = cached_text_layer_create(text_frame);
+  cached_text_layer_set_text(s_text_layer, "Example text.");
+  cached_text_layer_set_text_color(s_text_layer, GColorWhite);
+  // The text is cached along with what is behind it, so this has to match the window
+  cached_text_layer_set_background_color(s_text_layer, TEXT_ANIMATION_WINDOW_BACKGROUND_COLOR);
+  cached_text_layer_set_font(s_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  cached_text_layer_set_text_alignment(s_text_layer, GTextAlignmentCenter);
+  layer_add_child(window_layer, s_text_layer);
+
+  // Allocated once, every shake reuses it
+  s_text_change_animation = text_change_animation_create(s_text_layer, text_frame,
+    TEXT_ANIMATION_WINDOW_DISTANCE, TEXT_ANIMATION_WINDOW_DURATION);
+  text_change_animation_set_swap_handler(s_text_change_animation, swap_text_handler, NULL);
 }
 
 static void window_unload(Window *window) {
-  text_layer_destroy(s_text_layer);
+  text_change_animation_destroy(s_text_change_animation);
+  cached_text_layer_destroy(s_text_layer);
   window_destroy(s_window);
   s_window = NULL;
 }
 
+static void window_appear(Window *window) {
+  animate();
+}
+
 static void window_disappear(Window *window) {
-  if(s_timer) {
-    app_timer_cancel(s_timer);
-    s_timer = NULL;
-  }
+  frame_scheduler_cancel(animate_callback, NULL);
+  // Nothing is left running while the window is hidden
+  text_change_animation_finish(s_text_change_animation);
 }
 
 void text_animation_window_push() {
@@ -87,14 +103,13 @@ void text_animation_window_push() {
 
   if(!s_window) {
     s_window = window_create();
-    window_set_background_color(s_window, PBL_IF_COLOR_ELSE(GColorBlueMoon, GColorBlack));
+    window_set_background_color(s_window, TEXT_ANIMATION_WINDOW_BACKGROUND_COLOR);
     window_set_window_handlers(s_window, (WindowHandlers) {
       .load = window_load,
       .unload = window_unload,
+      .appear = window_appear,
       .disappear = window_disappear
     });
   }
   window_stack_push(s_window, true);
-
-  animate();
 }
@@ -2,8 +2,16 @@
 
 #include <pebble.h>
 
+#include "../layers/cached_text_layer.h"
+#include "../modules/frame_scheduler.h"
+#include "../modules/power_policy.h"
+#include "../modules/text_change_animation.h"
+
 #define TEXT_ANIMATION_WINDOW_DURATION 40   // Duration of each half of the animation
 #define TEXT_ANIMATION_WINDOW_DISTANCE 5    // Pixels the animating text move by
+#define TEXT_ANIMATION_WINDOW_OVERSHOOT 1   // Pixels the text overshoots by on the way back in
 #define TEXT_ANIMATION_WINDOW_INTERVAL 1000 // Interval between timers
+#define TEXT_ANIMATION_WINDOW_TEXT_HEIGHT 60 // Room for two lines of GOTHIC_24_BOLD
+#define TEXT_ANIMATION_WINDOW_BACKGROUND_COLOR PBL_IF_COLOR_ELSE(GColorBlueMoon, GColorBlack)
 
 void text_animation_window_push();
@@ -0,0 +1,62 @@
+#!/bin/sh
+# Builds and runs the host-side tests with the system compiler. The Pebble SDK is not needed, tests
+# of SDK-facing code build against the fake SDK in test/stub.
+#
+#   ./test/run_tests.sh
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+OUT=${OUT:-"$ROOT/build/test"}
+CC=${CC:-cc}
+CFLAGS="-std=c99 -Wall -Werror -g"
+
+mkdir -p "$OUT"
+
+run() {
+  name=$1
+  shift
+  $CC $CFLAGS -o "$OUT/$name" "$@"
+  "$OUT/$name"
+}
+
+run test_mailbox -I"$ROOT/src/modules" \
+  "$ROOT/test/test_mailbox.c" "$ROOT/src/modules/mailbox.c"
+
+# Code that talks to the SDK is built against the fake one
+FAKE_PEBBLE="-I$ROOT/test/stub -I$ROOT/src $ROOT/test/stub/fake_pebble.c"
+
+run test_frame_scheduler $FAKE_PEBBLE \
+  "$ROOT/test/test_frame_scheduler.c" "$ROOT/src/modules/frame_scheduler.c" \
+  "$ROOT/src/modules/power_policy.c" "$ROOT/src/modules/time_util.c"
+
+run test_text_change_animation $FAKE_PEBBLE \
+  "$ROOT/test/test_text_change_animation.c" "$ROOT/src/modules/text_change_animation.c" \
+  "$ROOT/src/modules/easing.c" "$ROOT/src/modules/frame_scheduler.c" \
+  "$ROOT/src/modules/power_policy.c" "$ROOT/src/modules/time_util.c"
+
+run test_selection_layer $FAKE_PEBBLE \
+  "$ROOT/test/test_selection_layer.c" "$ROOT/src/layers/selection_layer.c" \
+  "$ROOT/src/modules/easing.c" "$ROOT/src/modules/frame_scheduler.c" \
+  "$ROOT/src/modules/frame_watchdog.c" "$ROOT/src/modules/power_policy.c" \
+  "$ROOT/src/modules/time_util.c"
+
+run test_selection_layer_math $FAKE_PEBBLE \
+  "$ROOT/test/test_selection_layer_math.c" \
+  "$ROOT/src/modules/easing.c" "$ROOT/src/modules/frame_scheduler.c" \
+  "$ROOT/src/modules/frame_watchdog.c" "$ROOT/src/modules/power_policy.c" \
+  "$ROOT/src/modules/time_util.c" -lm
+
+run test_progress_layer $FAKE_PEBBLE \
+  "$ROOT/test/test_progress_layer.c" "$ROOT/src/layers/progress_layer.c" \
+  "$ROOT/src/modules/easing.c" "$ROOT/src/modules/frame_scheduler.c" \
+  "$ROOT/src/modules/power_policy.c" "$ROOT/src/modules/time_util.c"
+
+run test_progress_stream $FAKE_PEBBLE \
+  "$ROOT/test/test_progress_stream.c" "$ROOT/src/modules/progress_stream.c" \
+  "$ROOT/src/modules/mailbox.c" "$ROOT/src/layers/progress_layer.c" \
+  "$ROOT/src/modules/easing.c" "$ROOT/src/modules/frame_scheduler.c" \
+  "$ROOT/src/modules/power_policy.c" "$ROOT/src/modules/time_util.c"
+
+run test_cached_text_layer $FAKE_PEBBLE \
+  "$ROOT/test/test_cached_text_layer.c" "$ROOT/src/layers/cached_text_layer.c"
@@ -0,0 +1,596 @@
+#include "fake_pebble.h"
+
+// The fake's own allocations stand in for the system's, and are not counted
+#undef malloc
+
+#define MAX_TIMERS 16
+// Far enough from zero that code subtracting durations from now never wraps
+#define START_TIME_MS 1000000
+
+struct Layer {
+  GRect frame;
+  GRect bounds;
+  LayerUpdateProc update_proc;
+  bool is_hidden;
+  Layer *parent;
+  Layer *first_child;
+  Layer *next_sibling;
+  // Layer data is allocated along with the layer, as it is on the watch
+  uint64_t data[];
+};
+
+struct GBitmap {
+  GSize size;
+  GBitmapFormat format;
+  uint16_t bytes_per_row;
+  uint8_t *data;
+};
+
+struct GContext {
+  // Screen position of the layer being drawn
+  GPoint offset;
+  GColor fill_color;
+  GColor text_color;
+};
+
+struct AppTimer {
+  bool is_active;
+  uint32_t due_ms;
+  AppTimerCallback callback;
+  void *callback_data;
+};
+
+static FakePebbleCounters s_counters;
+static uint32_t s_now_ms = START_TIME_MS;
+static AppTimer s_timers[MAX_TIMERS];
+static uint32_t s_timer_latency_ms;
+static bool s_needs_render;
+
+static uint8_t s_frame_buffer_data[FAKE_PEBBLE_SCREEN_WIDTH * FAKE_PEBBLE_SCREEN_HEIGHT];
+static GBitmap s_frame_buffer = {
+  .size = {FAKE_PEBBLE_SCREEN_WIDTH, FAKE_PEBBLE_SCREEN_HEIGHT},
+  .format = GBitmapFormat8Bit,
+  .bytes_per_row = FAKE_PEBBLE_SCREEN_WIDTH,
+  .data = s_frame_buffer_data,
+};
+static GContext s_context;
+static bool s_is_round;
+
+static void *s_click_contexts[NUM_BUTTONS];
+static ClickHandler s_click_handlers[NUM_BUTTONS];
+
+static BatteryChargeState s_battery_state = {.charge_percent = 100};
+static BatteryStateHandler s_battery_handler;
+
+static FakeFont s_gothic_14 = {.line_height = 14, .glyph_top = 5, .glyph_width = 7, .glyph_height = 9};
+static FakeFont s_gothic_18_bold = {.line_height = 18, .glyph_top = 6, .glyph_width = 9, .glyph_height = 11};
+static FakeFont s_gothic_24_bold = {.line_height = 24, .glyph_top = 10, .glyph_width = 12, .glyph_height = 14};
+static FakeFont s_gothic_28_bold = {.line_height = 28, .glyph_top = 10, .glyph_width = 14, .glyph_height = 18};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Test hooks
+
+void fake_pebble_reset(void) {
+  s_counters = (FakePebbleCounters) {0};
+  s_now_ms = START_TIME_MS;
+  memset(s_timers, 0, sizeof(s_timers));
+  s_timer_latency_ms = 0;
+  s_needs_render = false;
+  s_is_round = false;
+  memset(s_frame_buffer_data, GColorWhite.argb, sizeof(s_frame_buffer_data));
+  memset(s_click_contexts, 0, sizeof(s_click_contexts));
+  memset(s_click_handlers, 0, sizeof(s_click_handlers));
+  s_battery_state = (BatteryChargeState) {.charge_percent = 100};
+  s_battery_handler = NULL;
+}
+
+FakePebbleCounters *fake_pebble_get_counters(void) {
+  return &s_counters;
+}
+
+uint32_t fake_pebble_get_time_ms(void) {
+  return s_now_ms;
+}
+
+static AppTimer *prv_get_next_due_timer(uint32_t until_ms) {
+  AppTimer *next = NULL;
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    AppTimer *timer = &s_timers[i];
+    if (timer->is_active && (int32_t)(timer->due_ms - until_ms) <= 0 &&
+        (!next || (int32_t)(timer->due_ms - next->due_ms) < 0)) {
+      next = timer;
+    }
+  }
+  return next;
+}
+
+void fake_pebble_advance_ms(uint32_t ms) {
+  const uint32_t until_ms = s_now_ms + ms;
+  AppTimer *timer;
+  while ((timer = prv_get_next_due_timer(until_ms))) {
+    if ((int32_t)(timer->due_ms - s_now_ms) > 0) {
+      s_now_ms = timer->due_ms;
+    }
+    timer->is_active = false;
+    timer->callback(timer->callback_data);
+  }
+  s_now_ms = until_ms;
+}
+
+uint32_t fake_pebble_get_pending_timer_count(void) {
+  uint32_t count = 0;
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    count += s_timers[i].is_active ? 1 : 0;
+  }
+  return count;
+}
+
+void fake_pebble_set_timer_latency_ms(uint32_t latency_ms) {
+  s_timer_latency_ms = latency_ms;
+}
+
+static GPoint prv_get_screen_origin(const Layer *layer) {
+  GPoint origin = GPointZero;
+  for (; layer; layer = layer->parent) {
+    origin.x += layer->frame.origin.x + layer->bounds.origin.x;
+    origin.y += layer->frame.origin.y + layer->bounds.origin.y;
+  }
+  return origin;
+}
+
+static void prv_render_layer(Layer *layer) {
+  if (layer->is_hidden) {
+    return;
+  }
+  if (layer->update_proc) {
+    s_context.offset = prv_get_screen_origin(layer);
+    layer->update_proc(layer, &s_context);
+  }
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    prv_render_layer(child);
+  }
+}
+
+bool fake_pebble_render(Layer *layer) {
+  if (!s_needs_render) {
+    return false;
+  }
+  s_needs_render = false;
+
+  // The window's root layer clears the screen before anything is drawn
+  memset(s_frame_buffer_data, GColorWhite.argb, sizeof(s_frame_buffer_data));
+  s_context = (GContext) {
+    .fill_color = GColorBlack,
+    .text_color = GColorBlack,
+  };
+  prv_render_layer(layer);
+  return true;
+}
+
+GColor fake_pebble_get_pixel(int16_t x, int16_t y) {
+  if (x < 0 || y < 0 || x >= FAKE_PEBBLE_SCREEN_WIDTH || y >= FAKE_PEBBLE_SCREEN_HEIGHT) {
+    return GColorClear;
+  }
+  return (GColor) {.argb = s_frame_buffer_data[(y * FAKE_PEBBLE_SCREEN_WIDTH) + x]};
+}
+
+void fake_pebble_set_round(bool is_round) {
+  s_is_round = is_round;
+}
+
+static bool s_is_not_repeating = false;
+static bool s_is_repeating = true;
+
+void fake_pebble_click(ButtonId button_id) {
+  if (s_click_handlers[button_id]) {
+    s_click_handlers[button_id](&s_is_not_repeating, s_click_contexts[button_id]);
+  }
+}
+
+void fake_pebble_repeat(ButtonId button_id) {
+  if (s_click_handlers[button_id]) {
+    s_click_handlers[button_id](&s_is_repeating, s_click_contexts[button_id]);
+  }
+}
+
+void fake_pebble_set_battery_state(BatteryChargeState state) {
+  s_battery_state = state;
+  if (s_battery_handler) {
+    s_battery_handler(state);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Memory
+
+void *fake_pebble_malloc(size_t size) {
+  s_counters.malloc_count++;
+  return malloc(size);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Geometry
+
+bool gpoint_equal(const GPoint *point_a, const GPoint *point_b) {
+  return point_a->x == point_b->x && point_a->y == point_b->y;
+}
+
+bool grect_equal(const GRect *rect_a, const GRect *rect_b) {
+  return gpoint_equal(&rect_a->origin, &rect_b->origin) &&
+         rect_a->size.w == rect_b->size.w && rect_a->size.h == rect_b->size.h;
+}
+
+GPoint grect_center_point(const GRect *rect) {
+  return GPoint(rect->origin.x + (rect->size.w / 2), rect->origin.y + (rect->size.h / 2));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Graphics
+
+bool gcolor_equal(GColor8 color_a, GColor8 color_b) {
+  return color_a.argb == color_b.argb;
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = malloc(sizeof(GBitmap));
+  bitmap->size = size;
+  bitmap->format = format;
+  // 1 bit rows are padded to a whole word
+  bitmap->bytes_per_row = (format == GBitmapFormat1Bit) ? ((size.w + 31) / 32) * 4 : size.w;
+  bitmap->data = calloc(size.h, bitmap->bytes_per_row);
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap) {
+    free(bitmap->data);
+    free(bitmap);
+  }
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return GRect(0, 0, bitmap->size.w, bitmap->size.h);
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->bytes_per_row;
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+  return bitmap->data;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+  GBitmapDataRowInfo info = {
+    .data = bitmap->data + (y * bitmap->bytes_per_row),
+    .min_x = 0,
+    .max_x = bitmap->size.w - 1,
+  };
+  if (s_is_round && bitmap == &s_frame_buffer) {
+    // Half the width of the circle's chord through the middle of the row
+    const int radius = FAKE_PEBBLE_SCREEN_WIDTH / 2;
+    const int dy = abs((2 * y) + 1 - FAKE_PEBBLE_SCREEN_HEIGHT) / 2;
+    int half_width = 0;
+    while (dy < radius && (half_width + 1) * (half_width + 1) <= (radius * radius) - (dy * dy)) {
+      half_width++;
+    }
+    info.min_x = radius - half_width;
+    info.max_x = radius + half_width - 1;
+  }
+  return info;
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  s_counters.frame_buffer_capture_count++;
+  return &s_frame_buffer;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *frame_buffer) {
+  return true;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+  ctx->fill_color = color;
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+  ctx->text_color = color;
+}
+
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width) {
+}
+
+// Lines are not drawn, nothing tested yet looks at them
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1) {
+}
+
+static void prv_set_pixel(int x, int y, GColor color) {
+  if (x >= 0 && y >= 0 && x < FAKE_PEBBLE_SCREEN_WIDTH && y < FAKE_PEBBLE_SCREEN_HEIGHT) {
+    s_frame_buffer_data[(y * FAKE_PEBBLE_SCREEN_WIDTH) + x] = color.argb;
+  }
+}
+
+// Fills a rect given in the coordinates of the layer being drawn
+static void prv_fill_rect(GContext *ctx, GRect rect, GColor color) {
+  for (int y = 0; y < rect.size.h; y++) {
+    for (int x = 0; x < rect.size.w; x++) {
+      prv_set_pixel(ctx->offset.x + rect.origin.x + x, ctx->offset.y + rect.origin.y + y, color);
+    }
+  }
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+  s_counters.fill_rect_count++;
+  prv_fill_rect(ctx, rect, ctx->fill_color);
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  for (int y = 0; y < rect.size.h && y < bitmap->size.h; y++) {
+    const uint8_t *row = bitmap->data + (y * bitmap->bytes_per_row);
+    for (int x = 0; x < rect.size.w && x < bitmap->size.w; x++) {
+      GColor color = {.argb = row[x]};
+      if (bitmap->format == GBitmapFormat1Bit) {
+        color = ((row[x / 8] >> (x % 8)) & 1) ? GColorWhite : GColorBlack;
+      }
+      prv_set_pixel(ctx->offset.x + rect.origin.x + x, ctx->offset.y + rect.origin.y + y, color);
+    }
+  }
+}
+
+static int prv_get_longest_line_length(const char *text, int *num_lines) {
+  int longest = 0;
+  int length = 0;
+  *num_lines = 1;
+  for (const char *c = text; *c; c++) {
+    if (*c == '\n') {
+      (*num_lines)++;
+      length = 0;
+    } else if (++length > longest) {
+      longest = length;
+    }
+  }
+  return longest;
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow_mode, GTextAlignment alignment,
+                        GTextAttributes *text_attributes) {
+  s_counters.draw_text_count++;
+
+  int line = 0;
+  const char *line_start = text;
+  while (line_start) {
+    const char *line_end = strchr(line_start, '\n');
+    const int length = line_end ? (line_end - line_start) : (int)strlen(line_start);
+    const int width = length * font->glyph_width;
+
+    int x = box.origin.x;
+    if (alignment == GTextAlignmentCenter) {
+      x += (box.size.w - width) / 2;
+    } else if (alignment == GTextAlignmentRight) {
+      x += box.size.w - width;
+    }
+    const int y = box.origin.y + (line * font->line_height) + font->glyph_top;
+    prv_fill_rect(ctx, GRect(x, y, width, font->glyph_height), ctx->text_color);
+
+    line++;
+    line_start = line_end ? line_end + 1 : NULL;
+  }
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode,
+                                            GTextAlignment alignment) {
+  int num_lines;
+  const int longest = prv_get_longest_line_length(text, &num_lines);
+  return GSize(longest * font->glyph_width, num_lines * font->line_height);
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+  if (strcmp(font_key, FONT_KEY_GOTHIC_14) == 0) {
+    return &s_gothic_14;
+  } else if (strcmp(font_key, FONT_KEY_GOTHIC_18_BOLD) == 0) {
+    return &s_gothic_18_bold;
+  } else if (strcmp(font_key, FONT_KEY_GOTHIC_24_BOLD) == 0) {
+    return &s_gothic_24_bold;
+  } else if (strcmp(font_key, FONT_KEY_GOTHIC_28_BOLD) == 0) {
+    return &s_gothic_28_bold;
+  }
+  return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Layers and windows
+
+Layer *layer_create(GRect frame) {
+  return layer_create_with_data(frame, 0);
+}
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+  Layer *layer = calloc(1, sizeof(Layer) + data_size);
+  layer->frame = frame;
+  layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+  return layer;
+}
+
+void layer_destroy(Layer *layer) {
+  if (layer) {
+    layer_remove_from_parent(layer);
+    free(layer);
+  }
+}
+
+void *layer_get_data(const Layer *layer) {
+  return (void *)layer->data;
+}
+
+void layer_mark_dirty(Layer *layer) {
+  s_counters.mark_dirty_count++;
+  s_needs_render = true;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  layer->frame = frame;
+  layer->bounds.size = frame.size;
+  s_needs_render = true;
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+void layer_set_bounds(Layer *layer, GRect bounds) {
+  layer->bounds = bounds;
+  s_needs_render = true;
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return layer->bounds;
+}
+
+void layer_set_clips(Layer *layer, bool clips) {
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  layer->is_hidden = hidden;
+  s_needs_render = true;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  layer_remove_from_parent(child);
+  child->parent = parent;
+  Layer **link = &parent->first_child;
+  while (*link) {
+    link = &(*link)->next_sibling;
+  }
+  *link = child;
+  s_needs_render = true;
+}
+
+void layer_remove_from_parent(Layer *child) {
+  if (!child->parent) {
+    return;
+  }
+  for (Layer **link = &child->parent->first_child; *link; link = &(*link)->next_sibling) {
+    if (*link == child) {
+      *link = child->next_sibling;
+      break;
+    }
+  }
+  child->parent = NULL;
+  child->next_sibling = NULL;
+  s_needs_render = true;
+}
+
+Layer *layer_get_parent(const Layer *layer) {
+  return layer->parent;
+}
+
+Window *window_stack_pop(bool animated) {
+  s_counters.window_pop_count++;
+  return NULL;
+}
+
+void window_set_click_config_provider_with_context(Window *window,
+                                                   ClickConfigProvider click_config_provider,
+                                                   void *context) {
+  // The system calls the provider when the window comes to the front, which for a test is now
+  for (int i = 0; i < NUM_BUTTONS; i++) {
+    s_click_contexts[i] = context;
+  }
+  click_config_provider(context);
+}
+
+void window_set_click_context(ButtonId button_id, void *context) {
+  s_click_contexts[button_id] = context;
+}
+
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler) {
+  s_click_handlers[button_id] = handler;
+}
+
+void window_single_repeating_click_subscribe(ButtonId button_id, uint16_t repeat_interval_ms,
+                                             ClickHandler handler) {
+  s_click_handlers[button_id] = handler;
+}
+
+bool click_recognizer_is_repeating(ClickRecognizerRef recognizer) {
+  return *(bool *)recognizer;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Animation
+
+Animation *animation_create(void) {
+  s_counters.animation_create_count++;
+  return NULL;
+}
+
+bool animation_schedule(Animation *animation) {
+  return false;
+}
+
+bool animation_unschedule(Animation *animation) {
+  return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+//! Timers, time and battery
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (int i = 0; i < MAX_TIMERS; i++) {
+    AppTimer *timer = &s_timers[i];
+    if (!timer->is_active) {
+      s_counters.timer_register_count++;
+      *timer = (AppTimer) {
+        .is_active = true,
+        .due_ms = s_now_ms + timeout_ms + s_timer_latency_ms,
+        .callback = callback,
+        .callback_data = callback_data,
+      };
+      return timer;
+    }
+  }
+  return NULL;
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+  if (!timer->is_active) {
+    return false;
+  }
+  timer->due_ms = s_now_ms + new_timeout_ms + s_timer_latency_ms;
+  return true;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+  timer->is_active = false;
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+  if (tloc) {
+    *tloc = s_now_ms / 1000;
+  }
+  if (out_ms) {
+    *out_ms = s_now_ms % 1000;
+  }
+  return s_now_ms % 1000;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+  return s_battery_state;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+  s_battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+  s_battery_handler = NULL;
+}
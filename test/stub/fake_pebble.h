@@ -0,0 +1,58 @@
+#pragma once
+
+#include <pebble.h>
+
+// Test hooks for the fake SDK. Time only moves when a test advances it, timers fire as it does, and
+// drawing goes into an 8 bit frame buffer the size of a basalt screen so tests can look at pixels.
+
+#define FAKE_PEBBLE_SCREEN_WIDTH 144
+#define FAKE_PEBBLE_SCREEN_HEIGHT 168
+
+// Things the code under test has asked the SDK to do, reset by fake_pebble_reset()
+typedef struct {
+  uint32_t animation_create_count;
+  uint32_t timer_register_count;
+  uint32_t mark_dirty_count;
+  uint32_t fill_rect_count;
+  uint32_t draw_text_count;
+  uint32_t window_pop_count;
+  uint32_t frame_buffer_capture_count;
+  uint32_t malloc_count;
+} FakePebbleCounters;
+
+// Forgets all timers, click handlers and counters, clears the screen and sets the clock back
+void fake_pebble_reset(void);
+FakePebbleCounters *fake_pebble_get_counters(void);
+
+uint32_t fake_pebble_get_time_ms(void);
+// Moves the clock forward, firing every timer that falls due on the way in order
+void fake_pebble_advance_ms(uint32_t ms);
+uint32_t fake_pebble_get_pending_timer_count(void);
+// Makes every timer registered from now on fire latency_ms after it falls due, as they do on a
+// watch busy with something else
+void fake_pebble_set_timer_latency_ms(uint32_t latency_ms);
+
+// Runs the update procs of layer and its children as the system would for one frame, if anything
+// has been marked dirty since the last render. Returns true if it drew
+bool fake_pebble_render(Layer *layer);
+// The colour last drawn at a screen position
+GColor fake_pebble_get_pixel(int16_t x, int16_t y);
+// Makes the frame buffer report only the pixels inside a circle as wide as the screen as visible,
+// as a chalk frame buffer does through gbitmap_get_data_row_info()
+void fake_pebble_set_round(bool is_round);
+
+// Presses a button whose handler was set up through a click config provider. A repeat is what the
+// recognizer sends while the button is held
+void fake_pebble_click(ButtonId button_id);
+void fake_pebble_repeat(ButtonId button_id);
+
+// Fonts draw every character as a solid glyph_width x glyph_height block, glyph_top pixels below
+// the top of a line_height tall line, the way Pebble fonts leave space above the glyphs
+typedef struct FakeFont {
+  int16_t line_height;
+  int16_t glyph_top;
+  int16_t glyph_width;
+  int16_t glyph_height;
+} FakeFont;
+
+void fake_pebble_set_battery_state(BatteryChargeState state);
@@ -0,0 +1,249 @@
+#pragma once
+
+// The parts of the Pebble SDK 3 API that the modules under test use, for building them on the host.
+// Everything declared here is implemented by fake_pebble.c, see fake_pebble.h for the test hooks.
+// Types and values follow the SDK headers for a colour, rectangular (basalt) watch.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PBL_COLOR
+#define PBL_RECT
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_RECT_ELSE(if_true, if_false) (if_true)
+
+#define APP_LOG(level, fmt, ...) printf(fmt "\n", ##__VA_ARGS__)
+
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1,
+  APP_LOG_LEVEL_WARNING = 50,
+  APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200,
+} AppLogLevel;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Memory
+
+// The app heap. Allocations by the code under test go through the fake so tests can count them
+void *fake_pebble_malloc(size_t size);
+#define malloc(size) fake_pebble_malloc(size)
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Geometry
+
+typedef struct GPoint {
+  int16_t x;
+  int16_t y;
+} GPoint;
+
+typedef struct GSize {
+  int16_t w;
+  int16_t h;
+} GSize;
+
+typedef struct GRect {
+  GPoint origin;
+  GSize size;
+} GRect;
+
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GPointZero GPoint(0, 0)
+#define GSizeZero GSize(0, 0)
+#define GRectZero GRect(0, 0, 0, 0)
+
+bool gpoint_equal(const GPoint *point_a, const GPoint *point_b);
+bool grect_equal(const GRect *rect_a, const GRect *rect_b);
+GPoint grect_center_point(const GRect *rect);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Graphics
+
+typedef union GColor8 {
+  uint8_t argb;
+  struct {
+    uint8_t b:2;
+    uint8_t g:2;
+    uint8_t r:2;
+    uint8_t a:2;
+  };
+} GColor8;
+
+typedef GColor8 GColor;
+
+#define GColorClear ((GColor8){.argb = 0x00})
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+#define GColorRed ((GColor8){.argb = 0xF0})
+#define GColorYellow ((GColor8){.argb = 0xFC})
+#define GColorDarkGray ((GColor8){.argb = 0xD5})
+#define GColorLightGray ((GColor8){.argb = 0xEA})
+
+bool gcolor_equal(GColor8 color_a, GColor8 color_b);
+
+typedef enum {
+  GCornerNone = 0,
+  GCornersAll = 15,
+} GCornerMask;
+
+typedef enum {
+  GTextOverflowModeWordWrap,
+  GTextOverflowModeTrailingEllipsis,
+  GTextOverflowModeFill,
+} GTextOverflowMode;
+
+typedef enum {
+  GTextAlignmentLeft,
+  GTextAlignmentCenter,
+  GTextAlignmentRight,
+} GTextAlignment;
+
+typedef enum {
+  GBitmapFormat1Bit,
+  GBitmapFormat8Bit,
+} GBitmapFormat;
+
+typedef struct GContext GContext;
+typedef struct GBitmap GBitmap;
+typedef struct GTextAttributes GTextAttributes;
+typedef struct FakeFont *GFont;
+
+typedef struct GBitmapDataRowInfo {
+  uint8_t *data;
+  int16_t min_x;
+  int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+void gbitmap_destroy(GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *frame_buffer);
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width);
+void graphics_draw_line(GContext *ctx, GPoint p0, GPoint p1);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow_mode, GTextAlignment alignment,
+                        GTextAttributes *text_attributes);
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode,
+                                            GTextAlignment alignment);
+
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+#define FONT_KEY_GOTHIC_28_BOLD "RESOURCE_ID_GOTHIC_28_BOLD"
+
+GFont fonts_get_system_font(const char *font_key);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Layers and windows
+
+typedef struct Layer Layer;
+typedef struct Window Window;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void layer_destroy(Layer *layer);
+void *layer_get_data(const Layer *layer);
+void layer_mark_dirty(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_set_frame(Layer *layer, GRect frame);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_bounds(Layer *layer, GRect bounds);
+GRect layer_get_bounds(const Layer *layer);
+void layer_set_clips(Layer *layer, bool clips);
+void layer_set_hidden(Layer *layer, bool hidden);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_remove_from_parent(Layer *child);
+Layer *layer_get_parent(const Layer *layer);
+
+Window *window_stack_pop(bool animated);
+
+typedef enum {
+  BUTTON_ID_BACK,
+  BUTTON_ID_UP,
+  BUTTON_ID_SELECT,
+  BUTTON_ID_DOWN,
+  NUM_BUTTONS,
+} ButtonId;
+
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+
+void window_set_click_config_provider_with_context(Window *window,
+                                                   ClickConfigProvider click_config_provider,
+                                                   void *context);
+void window_set_click_context(ButtonId button_id, void *context);
+void window_single_click_subscribe(ButtonId button_id, ClickHandler handler);
+void window_single_repeating_click_subscribe(ButtonId button_id, uint16_t repeat_interval_ms,
+                                             ClickHandler handler);
+bool click_recognizer_is_repeating(ClickRecognizerRef recognizer);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Animation
+
+typedef struct Animation Animation;
+typedef int32_t AnimationProgress;
+
+#define ANIMATION_NORMALIZED_MIN 0
+#define ANIMATION_NORMALIZED_MAX 65535
+#define ANIMATION_DURATION_INFINITE UINT32_MAX
+
+typedef enum {
+  AnimationCurveLinear,
+  AnimationCurveEaseIn,
+  AnimationCurveEaseOut,
+  AnimationCurveEaseInOut,
+  AnimationCurveCustomFunction,
+} AnimationCurve;
+
+typedef AnimationProgress (*AnimationCurveFunction)(AnimationProgress linear_distance);
+
+// The fake has no animation system, creating one only counts the attempt and fails
+Animation *animation_create(void);
+bool animation_schedule(Animation *animation);
+bool animation_unschedule(Animation *animation);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Timers, time and battery
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer);
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+
+typedef struct BatteryChargeState {
+  uint8_t charge_percent;
+  bool is_charging;
+  bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+
+BatteryChargeState battery_state_service_peek(void);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
@@ -0,0 +1,119 @@
+// Host test for src/layers/cached_text_layer.c against the fake SDK. See run_tests.sh
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "fake_pebble.h"
+#include "layers/cached_text_layer.h"
+
+#define LAYER_WIDTH 100
+#define LAYER_HEIGHT 30
+
+static Layer *s_root_layer;
+
+static void prv_render(void) {
+  layer_mark_dirty(s_root_layer);
+  fake_pebble_render(s_root_layer);
+}
+
+static CachedTextLayer *prv_create_layer(GRect frame) {
+  fake_pebble_reset();
+  s_root_layer = layer_create(GRect(0, 0, FAKE_PEBBLE_SCREEN_WIDTH, FAKE_PEBBLE_SCREEN_HEIGHT));
+
+  CachedTextLayer *layer = cached_text_layer_create(frame);
+  cached_text_layer_set_font(layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+  cached_text_layer_set_text_color(layer, GColorRed);
+  layer_add_child(s_root_layer, layer);
+  return layer;
+}
+
+static void prv_destroy_layer(CachedTextLayer *layer) {
+  cached_text_layer_destroy(layer);
+  layer_destroy(s_root_layer);
+}
+
+static void test_text_is_cached_once_on_screen(void) {
+  CachedTextLayer *layer = prv_create_layer(GRect(10, 10, LAYER_WIDTH, LAYER_HEIGHT));
+  cached_text_layer_set_text(layer, "0");
+
+  prv_render();
+  assert(cached_text_layer_get_render_count(layer) == 1);
+  for (int i = 0; i < 3; i++) {
+    prv_render();
+  }
+  assert(cached_text_layer_get_render_count(layer) == 1);
+
+  prv_destroy_layer(layer);
+}
+
+static void test_text_changed_off_screen_is_not_cached_clipped(void) {
+  // Where a shake leaves the layer when the text is swapped, hanging off the left edge
+  CachedTextLayer *layer = prv_create_layer(GRect(-5, 10, LAYER_WIDTH, LAYER_HEIGHT));
+  cached_text_layer_set_text(layer, "0");
+  const FakeFont *font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+
+  // Drawn normally every frame while it is off the edge, without touching the frame buffer
+  prv_render();
+  prv_render();
+  assert(cached_text_layer_get_render_count(layer) == 2);
+  assert(fake_pebble_get_counters()->frame_buffer_capture_count == 0);
+
+  // Back at rest it is drawn once more and cached
+  layer_set_frame(layer, GRect(10, 10, LAYER_WIDTH, LAYER_HEIGHT));
+  prv_render();
+  prv_render();
+  assert(cached_text_layer_get_render_count(layer) == 3);
+
+  // The first column of the glyph survived the trip into the cache
+  const int glyph_y = 10 + font->glyph_top;
+  assert(gcolor_equal(fake_pebble_get_pixel(10, glyph_y), GColorRed));
+  assert(gcolor_equal(fake_pebble_get_pixel(10 + font->glyph_width - 1, glyph_y), GColorRed));
+  assert(gcolor_equal(fake_pebble_get_pixel(10 + font->glyph_width, glyph_y), GColorWhite));
+
+  prv_destroy_layer(layer);
+}
+
+static void test_round_display_caches_inside_the_visible_rows(void) {
+  // Across the middle of the screen, where the text animation window puts its text
+  const int16_t y = (FAKE_PEBBLE_SCREEN_HEIGHT / 2) - 24;
+  CachedTextLayer *layer = prv_create_layer(GRect(0, y, FAKE_PEBBLE_SCREEN_WIDTH, LAYER_HEIGHT));
+  fake_pebble_set_round(true);
+  cached_text_layer_set_text(layer, "0");
+  FakePebbleCounters *counters = fake_pebble_get_counters();
+
+  // Full width, the ends of the rows are outside the circle. One capture learns that, and the
+  // frame buffer is left alone after it
+  for (int i = 0; i < 4; i++) {
+    prv_render();
+  }
+  assert(cached_text_layer_get_render_count(layer) == 4);
+  assert(counters->frame_buffer_capture_count == 1);
+  prv_destroy_layer(layer);
+
+  // Inset clear of the edge, the way the window lays it out, the cache is taken straight away
+  layer = prv_create_layer(GRect(10, y, FAKE_PEBBLE_SCREEN_WIDTH - 20, LAYER_HEIGHT));
+  fake_pebble_set_round(true);
+  cached_text_layer_set_text(layer, "0");
+  for (int i = 0; i < 4; i++) {
+    prv_render();
+  }
+  assert(cached_text_layer_get_render_count(layer) == 1);
+  assert(counters->frame_buffer_capture_count == 1);
+
+  // The shake moves it sideways within the visible rows, still drawn from the cache
+  layer_set_frame(layer, GRect(4, y, FAKE_PEBBLE_SCREEN_WIDTH - 20, LAYER_HEIGHT));
+  prv_render();
+  layer_set_frame(layer, GRect(16, y, FAKE_PEBBLE_SCREEN_WIDTH - 20, LAYER_HEIGHT));
+  prv_render();
+  assert(cached_text_layer_get_render_count(layer) == 1);
+
+  prv_destroy_layer(layer);
+}
+
+int main(void) {
+  test_text_is_cached_once_on_screen();
+  test_text_changed_off_screen_is_not_cached_clipped();
+  test_round_display_caches_inside_the_visible_rows();
+  printf("test_cached_text_layer: passed\n");
+  return 0;
+}
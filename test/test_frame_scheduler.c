@@ -0,0 +1,87 @@
+// Host test for src/modules/frame_scheduler.c against the fake SDK. See run_tests.sh
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "fake_pebble.h"
+#include "modules/frame_scheduler.h"
+
+#define MAX_TICKS 16
+
+static uint32_t s_tick_times_ms[MAX_TICKS];
+static int s_tick_count;
+
+// A per frame client, asking for the next frame every time it runs
+static void prv_per_frame_callback(void *context) {
+  s_tick_times_ms[s_tick_count++] = time_util_get_ms();
+  if (s_tick_count < MAX_TICKS) {
+    frame_scheduler_schedule(prv_per_frame_callback, context, FRAME_SCHEDULER_FRAME_MS);
+  }
+}
+
+static void prv_noop_callback(void *context) {
+}
+
+static void prv_reset(void) {
+  fake_pebble_reset();
+  s_tick_count = 0;
+}
+
+static void prv_assert_ticks_are_apart(uint32_t gap_ms) {
+  assert(s_tick_count == MAX_TICKS);
+  for (int i = 1; i < s_tick_count; i++) {
+    assert(s_tick_times_ms[i] - s_tick_times_ms[i - 1] == gap_ms);
+  }
+}
+
+static void test_late_ticks_still_run_every_frame(void) {
+  prv_reset();
+  // Every wakeup arrives a little after the frame it was for
+  fake_pebble_set_timer_latency_ms(2);
+
+  frame_scheduler_schedule(prv_per_frame_callback, NULL, FRAME_SCHEDULER_FRAME_MS);
+  fake_pebble_advance_ms(MAX_TICKS * 2 * FRAME_SCHEDULER_FRAME_MS);
+  prv_assert_ticks_are_apart(FRAME_SCHEDULER_FRAME_MS);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+}
+
+static void test_low_power_stretches_frames_once(void) {
+  prv_reset();
+  power_policy_init();
+  fake_pebble_set_battery_state((BatteryChargeState) {.charge_percent = 10});
+  fake_pebble_set_timer_latency_ms(2);
+
+  frame_scheduler_schedule(prv_per_frame_callback, NULL, FRAME_SCHEDULER_FRAME_MS);
+  fake_pebble_advance_ms(MAX_TICKS * 4 * FRAME_SCHEDULER_FRAME_MS);
+  prv_assert_ticks_are_apart(POWER_POLICY_LOW_POWER_SCALE * FRAME_SCHEDULER_FRAME_MS);
+
+  power_policy_deinit();
+}
+
+static void test_full_table_refuses_new_callbacks(void) {
+  prv_reset();
+  static int s_contexts[FRAME_SCHEDULER_MAX_SLOTS + 1];
+
+  for (int i = 0; i < FRAME_SCHEDULER_MAX_SLOTS; i++) {
+    assert(frame_scheduler_schedule(prv_noop_callback, &s_contexts[i], FRAME_SCHEDULER_FRAME_MS));
+  }
+  assert(!frame_scheduler_schedule(prv_noop_callback, &s_contexts[FRAME_SCHEDULER_MAX_SLOTS],
+                                   FRAME_SCHEDULER_FRAME_MS));
+  // Moving a callback that already has a slot still works
+  assert(frame_scheduler_schedule(prv_noop_callback, &s_contexts[0], 2 * FRAME_SCHEDULER_FRAME_MS));
+
+  // All of them share one wakeup per frame
+  fake_pebble_advance_ms(3 * FRAME_SCHEDULER_FRAME_MS);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+  for (int i = 0; i < FRAME_SCHEDULER_MAX_SLOTS; i++) {
+    assert(!frame_scheduler_is_scheduled(prv_noop_callback, &s_contexts[i]));
+  }
+}
+
+int main(void) {
+  test_late_ticks_still_run_every_frame();
+  test_low_power_stretches_frames_once();
+  test_full_table_refuses_new_callbacks();
+  printf("test_frame_scheduler: passed\n");
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Host test for src/modules/mailbox.c, driven by a fake producer. See run_tests.sh
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mailbox.h"
+
+// Posts a burst of values the way AppMessage or the worker would, returning the last one
+static int16_t fake_producer_burst(Mailbox *mailbox, int16_t first, int16_t step, int count) {
+  int16_t value = first;
+  for (int i = 0; i < count; i++) {
+    value = first + (i * step);
+    mailbox_post(mailbox, value);
+  }
+  return value;
+}
+
+static void test_empty_mailbox_has_nothing_to_take(void) {
+  Mailbox mailbox;
+  mailbox_init(&mailbox);
+
+  int16_t value;
+  assert(!mailbox_take(&mailbox, &value));
+}
+
+static void test_burst_takes_newest(void) {
+  Mailbox mailbox;
+  mailbox_init(&mailbox);
+
+  // 5, 10, ..., 100
+  fake_producer_burst(&mailbox, 5, 5, 20);
+
+  int16_t value;
+  assert(mailbox_take(&mailbox, &value));
+  assert(value == 100);
+
+  // The producer going quiet leaves nothing else to apply
+  assert(!mailbox_take(&mailbox, &value));
+}
+
+static void test_same_value_posted_again_is_taken_again(void) {
+  Mailbox mailbox;
+  mailbox_init(&mailbox);
+
+  int16_t value;
+  mailbox_post(&mailbox, 42);
+  assert(mailbox_take(&mailbox, &value));
+  mailbox_post(&mailbox, 42);
+  assert(mailbox_take(&mailbox, &value));
+  assert(value == 42);
+}
+
+static void test_sequence_wraps(void) {
+  Mailbox mailbox;
+  mailbox_init(&mailbox);
+  mailbox.sequence = UINT32_MAX - 2;
+  mailbox.taken_sequence = UINT32_MAX - 2;
+
+  for (int16_t i = 0; i < 6; i++) {
+    mailbox_post(&mailbox, i);
+    int16_t value;
+    assert(mailbox_take(&mailbox, &value));
+    assert(value == i);
+  }
+}
+
+// Random bursts between frames, the consumer must always end up on the last value posted
+static void test_random_bursts_apply_latest(void) {
+  Mailbox mailbox;
+  mailbox_init(&mailbox);
+  srand(17);
+
+  int16_t applied = -1;
+  for (int frame = 0; frame < 10000; frame++) {
+    const int burst = rand() % 24;
+    int16_t last_posted = applied;
+    if (burst) {
+      last_posted = fake_producer_burst(&mailbox, rand() % 101, 1, burst);
+    }
+
+    int16_t value;
+    const bool taken = mailbox_take(&mailbox, &value);
+    assert(taken == (burst > 0));
+    if (taken) {
+      applied = value;
+    }
+    assert(applied == last_posted);
+  }
+}
+
+int main(void) {
+  test_empty_mailbox_has_nothing_to_take();
+  test_burst_takes_newest();
+  test_same_value_posted_again_is_taken_again();
+  test_sequence_wraps();
+  test_random_bursts_apply_latest();
+  printf("test_mailbox: passed\n");
+  return 0;
+}
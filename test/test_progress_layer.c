@@ -0,0 +1,71 @@
+// Host test for src/layers/progress_layer.c against the fake SDK. See run_tests.sh
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "fake_pebble.h"
+#include "layers/progress_layer.h"
+#include "modules/frame_scheduler.h"
+#include "modules/power_policy.h"
+
+#define BAR_WIDTH 100
+#define BAR_Y 10
+#define RUN_MS 1000
+
+// Runs the marquee for a while, drawing every frame it asks for. Returns the wakeups it took
+static uint32_t prv_run_marquee(ProgressLayer *progress_layer, uint32_t duration_ms) {
+  const uint32_t wakeup_count = frame_scheduler_get_wakeup_count();
+  for (uint32_t elapsed = 0; elapsed < duration_ms; elapsed += FRAME_SCHEDULER_FRAME_MS) {
+    fake_pebble_advance_ms(FRAME_SCHEDULER_FRAME_MS);
+    fake_pebble_render(progress_layer);
+  }
+  return frame_scheduler_get_wakeup_count() - wakeup_count;
+}
+
+static ProgressLayer *prv_create_layer(void) {
+  fake_pebble_reset();
+  ProgressLayer *progress_layer = progress_layer_create(GRect(0, BAR_Y, BAR_WIDTH, 6));
+  progress_layer_set_foreground_color(progress_layer, GColorRed);
+  return progress_layer;
+}
+
+static bool prv_bar_has_color(GColor color) {
+  for (int x = 0; x < BAR_WIDTH; x++) {
+    if (gcolor_equal(fake_pebble_get_pixel(x, BAR_Y + 1), color)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void test_low_power_marquee_wakes_half_as_often(void) {
+  ProgressLayer *progress_layer = prv_create_layer();
+  progress_layer_set_indeterminate(progress_layer, true);
+  const uint32_t full_power_wakeups = prv_run_marquee(progress_layer, RUN_MS);
+  assert(full_power_wakeups >= (RUN_MS / FRAME_SCHEDULER_FRAME_MS) - 1);
+  assert(prv_bar_has_color(GColorRed));
+  progress_layer_destroy(progress_layer);
+
+  progress_layer = prv_create_layer();
+  power_policy_init();
+  fake_pebble_set_battery_state((BatteryChargeState) {.charge_percent = 10});
+  progress_layer_set_indeterminate(progress_layer, true);
+  const uint32_t low_power_wakeups = prv_run_marquee(progress_layer, RUN_MS);
+  assert(low_power_wakeups <= (full_power_wakeups / POWER_POLICY_LOW_POWER_SCALE) + 1);
+  assert(prv_bar_has_color(GColorRed));
+
+  // Switching it off stops the wakeups and shows the percent again
+  progress_layer_set_indeterminate(progress_layer, false);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+  fake_pebble_render(progress_layer);
+  assert(!prv_bar_has_color(GColorRed));
+
+  power_policy_deinit();
+  progress_layer_destroy(progress_layer);
+}
+
+int main(void) {
+  test_low_power_marquee_wakes_half_as_often();
+  printf("test_progress_layer: passed\n");
+  return 0;
+}
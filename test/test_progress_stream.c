@@ -0,0 +1,64 @@
+// Host test for src/modules/progress_stream.c against the fake SDK. See run_tests.sh
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "fake_pebble.h"
+#include "modules/progress_stream.h"
+
+#define BAR_WIDTH 100
+#define BAR_Y 10
+#define NUM_FRAMES 10
+
+// Width of the bar as drawn, found from its pixels
+static int prv_get_drawn_width(void) {
+  int width = 0;
+  while (width < BAR_WIDTH && gcolor_equal(fake_pebble_get_pixel(width, BAR_Y + 1), GColorRed)) {
+    width++;
+  }
+  return width;
+}
+
+static void test_only_the_newest_value_is_drawn(void) {
+  fake_pebble_reset();
+  ProgressLayer *progress_layer = progress_layer_create(GRect(0, BAR_Y, BAR_WIDTH, 6));
+  progress_layer_set_foreground_color(progress_layer, GColorRed);
+  progress_layer_set_corner_radius(progress_layer, 0);
+  ProgressStream *stream = progress_stream_create(progress_layer);
+  fake_pebble_render(progress_layer);
+  FakePebbleCounters *counters = fake_pebble_get_counters();
+
+  for (int frame = 1; frame <= NUM_FRAMES; frame++) {
+    const uint32_t wakeup_count = frame_scheduler_get_wakeup_count();
+    const uint32_t mark_dirty_count = counters->mark_dirty_count;
+
+    // A burst of values from the producer between two frames, ending on frame * 5 percent
+    for (int value = (frame - 1) * 5; value <= frame * 5; value++) {
+      progress_stream_push(stream, value);
+    }
+    assert(counters->mark_dirty_count == mark_dirty_count);
+
+    fake_pebble_advance_ms(FRAME_SCHEDULER_FRAME_MS);
+    assert(fake_pebble_render(progress_layer));
+    assert(prv_get_drawn_width() == frame * 5);
+
+    // One wakeup and one redraw for the whole burst
+    assert(frame_scheduler_get_wakeup_count() - wakeup_count == 1);
+    assert(counters->mark_dirty_count - mark_dirty_count == 1);
+  }
+  assert(progress_stream_get_apply_count(stream) == NUM_FRAMES);
+
+  // Nothing is pushed, nothing wakes
+  fake_pebble_advance_ms(10 * FRAME_SCHEDULER_FRAME_MS);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+  assert(progress_stream_get_apply_count(stream) == NUM_FRAMES);
+
+  progress_stream_destroy(stream);
+  progress_layer_destroy(progress_layer);
+}
+
+int main(void) {
+  test_only_the_newest_value_is_drawn();
+  printf("test_progress_stream: passed\n");
+  return 0;
+}
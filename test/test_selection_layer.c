@@ -0,0 +1,305 @@
+// Host test for src/layers/selection_layer.c against the fake SDK. See run_tests.sh
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "fake_pebble.h"
+#include "layers/selection_layer.h"
+#include "modules/power_policy.h"
+
+#define NUM_CELLS 3
+#define CELL_WIDTH 40
+// Longer than any animation phase
+#define SETTLE_MS 1000
+
+static int s_values[NUM_CELLS];
+static char s_text[NUM_CELLS][SELECTION_LAYER_CELL_TEXT_LENGTH];
+static int s_complete_count;
+
+static char *prv_get_cell_text(int index, void *context) {
+  snprintf(s_text[index], sizeof(s_text[index]), "%d", s_values[index]);
+  return s_text[index];
+}
+
+static void prv_complete(void *context) {
+  s_complete_count++;
+}
+
+static void prv_increment(int index, uint16_t count, void *context) {
+  s_values[index] += count;
+}
+
+static void prv_decrement(int index, uint16_t count, void *context) {
+  s_values[index] -= count;
+}
+
+static Layer *prv_create_layer(void) {
+  fake_pebble_reset();
+  memset(s_values, 0, sizeof(s_values));
+  s_complete_count = 0;
+
+  Layer *layer = selection_layer_create(GRect(0, 40, FAKE_PEBBLE_SCREEN_WIDTH, 40), NUM_CELLS);
+  for (int i = 0; i < NUM_CELLS; i++) {
+    selection_layer_set_cell_width(layer, i, CELL_WIDTH);
+  }
+  selection_layer_set_callbacks(layer, NULL, (SelectionLayerCallbacks) {
+    .get_cell_text = prv_get_cell_text,
+    .complete = prv_complete,
+    .increment = prv_increment,
+    .decrement = prv_decrement,
+  });
+  selection_layer_set_click_config_onto_window(layer, (Window *)layer);
+  fake_pebble_render(layer);
+  return layer;
+}
+
+// Lets the frame scheduler tick for a while, drawing whenever the layer asks to be drawn
+static void prv_run_frames(Layer *layer, uint32_t duration_ms) {
+  for (uint32_t elapsed = 0; elapsed < duration_ms; elapsed += FRAME_SCHEDULER_FRAME_MS) {
+    fake_pebble_advance_ms(FRAME_SCHEDULER_FRAME_MS);
+    fake_pebble_render(layer);
+  }
+}
+
+static void test_presses_allocate_no_animations(void) {
+  Layer *layer = prv_create_layer();
+
+  // Single presses, each started from idle
+  for (int i = 0; i < 5; i++) {
+    fake_pebble_click(BUTTON_ID_UP);
+    assert(fake_pebble_get_pending_timer_count() == 1);
+    prv_run_frames(layer, SETTLE_MS);
+    // The engine stops with the tracks, leaving no timer behind
+    assert(fake_pebble_get_pending_timer_count() == 0);
+  }
+  assert(s_values[0] == 5);
+
+  // Rapid presses, each interrupting the last
+  for (int i = 0; i < 5; i++) {
+    fake_pebble_click(BUTTON_ID_DOWN);
+    prv_run_frames(layer, FRAME_SCHEDULER_FRAME_MS);
+  }
+  prv_run_frames(layer, SETTLE_MS);
+  assert(s_values[0] == 0);
+
+  // A hold, then moving through every cell to the end
+  fake_pebble_click(BUTTON_ID_UP);
+  for (int i = 0; i < 10; i++) {
+    fake_pebble_advance_ms(100);
+    fake_pebble_repeat(BUTTON_ID_UP);
+    fake_pebble_render(layer);
+  }
+  prv_run_frames(layer, SETTLE_MS);
+  assert(s_values[0] == 11);
+  for (int i = 0; i < NUM_CELLS; i++) {
+    fake_pebble_click(BUTTON_ID_SELECT);
+    prv_run_frames(layer, SETTLE_MS);
+  }
+  assert(s_complete_count == 1);
+
+  assert(fake_pebble_get_counters()->animation_create_count == 0);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+  selection_layer_destroy(layer);
+}
+
+static GColor prv_get_cell_color(Layer *layer, int index) {
+  const GRect layer_frame = layer_get_frame(layer);
+  const GRect cell_frame = selection_layer_get_cell_frame(layer, index);
+  // A corner, clear of the text
+  return fake_pebble_get_pixel(layer_frame.origin.x + cell_frame.origin.x + 1,
+                               layer_frame.origin.y + cell_frame.origin.y + 1);
+}
+
+static void test_cells_are_drawn_in_their_state(void) {
+  Layer *layer = prv_create_layer();
+  assert(gcolor_equal(prv_get_cell_color(layer, 0), GColorWhite));
+  for (int i = 1; i < NUM_CELLS; i++) {
+    assert(gcolor_equal(prv_get_cell_color(layer, i), GColorDarkGray));
+  }
+
+  // Moving on paints the cell left and the cell arrived at
+  fake_pebble_click(BUTTON_ID_SELECT);
+  prv_run_frames(layer, SETTLE_MS);
+  assert(gcolor_equal(prv_get_cell_color(layer, 0), GColorDarkGray));
+  assert(gcolor_equal(prv_get_cell_color(layer, 1), GColorWhite));
+
+  selection_layer_destroy(layer);
+}
+
+static bool prv_row_is_clear_of(int16_t y, GColor color) {
+  for (int16_t x = 0; x < FAKE_PEBBLE_SCREEN_WIDTH; x++) {
+    if (gcolor_equal(fake_pebble_get_pixel(x, y), color)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void test_row_change_stays_in_the_rows(void) {
+  Layer *layer = prv_create_layer();
+  selection_layer_set_num_columns(layer, 2);
+  selection_layer_set_active_bg_color(layer, GColorRed);
+  fake_pebble_click(BUTTON_ID_SELECT);
+  prv_run_frames(layer, SETTLE_MS);
+
+  // From the end of the first row to the start of the second
+  const GRect layer_frame = layer_get_frame(layer);
+  const GRect top_frame = selection_layer_get_cell_frame(layer, 1);
+  const GRect bottom_frame = selection_layer_get_cell_frame(layer, 2);
+  const int16_t top_y = layer_frame.origin.y + top_frame.origin.y + 1;
+  const int16_t gap_y = layer_frame.origin.y + top_frame.origin.y + top_frame.size.h;
+  const int16_t bottom_y = layer_frame.origin.y + bottom_frame.origin.y + 1;
+  assert(gap_y < bottom_y - 1);
+
+  bool left_the_top = false;
+  fake_pebble_click(BUTTON_ID_SELECT);
+  for (uint32_t elapsed = 0; elapsed < SETTLE_MS; elapsed += FRAME_SCHEDULER_FRAME_MS) {
+    fake_pebble_advance_ms(FRAME_SCHEDULER_FRAME_MS);
+    fake_pebble_render(layer);
+    // Nothing crosses the gap between the rows, or the cells that are not involved
+    assert(prv_row_is_clear_of(gap_y, GColorRed));
+    assert(!gcolor_equal(prv_get_cell_color(layer, 0), GColorRed));
+    left_the_top |= !gcolor_equal(prv_get_cell_color(layer, 1), GColorRed);
+  }
+  assert(left_the_top);
+  assert(prv_row_is_clear_of(top_y, GColorRed));
+  assert(gcolor_equal(prv_get_cell_color(layer, 2), GColorRed));
+  assert(!prv_row_is_clear_of(bottom_y, GColorRed));
+
+  selection_layer_destroy(layer);
+}
+
+static void test_other_fonts_are_measured_from_their_glyphs(void) {
+  Layer *layer = prv_create_layer();
+  SelectionLayerData *data = layer_get_data(layer);
+  // Proportions no ratio of GOTHIC_28_BOLD would give
+  FakeFont font = {.line_height = 40, .glyph_top = 13, .glyph_width = 20, .glyph_height = 22};
+
+  selection_layer_set_font(layer, &font);
+  assert(!data->font_metrics_are_valid);
+  fake_pebble_render(layer);
+  assert(data->font_metrics_are_valid);
+  assert(data->font_height == font.glyph_height);
+  assert(data->font_top_padding == font.glyph_top);
+
+  // The glyphs, not the line, are centred in the cell
+  const GRect layer_frame = layer_get_frame(layer);
+  const GRect cell_frame = selection_layer_get_cell_frame(layer, 1);
+  const int glyph_top = layer_frame.origin.y + ((cell_frame.size.h - font.glyph_height) / 2);
+  const int glyph_x = layer_frame.origin.x + cell_frame.origin.x + (CELL_WIDTH / 2);
+  assert(gcolor_equal(fake_pebble_get_pixel(glyph_x, glyph_top - 1), GColorDarkGray));
+  assert(gcolor_equal(fake_pebble_get_pixel(glyph_x, glyph_top), GColorBlack));
+  assert(gcolor_equal(fake_pebble_get_pixel(glyph_x, glyph_top + font.glyph_height - 1), GColorBlack));
+  assert(gcolor_equal(fake_pebble_get_pixel(glyph_x, glyph_top + font.glyph_height), GColorDarkGray));
+
+  selection_layer_destroy(layer);
+}
+
+static void test_font_measured_through_scrolled_parent(void) {
+  Layer *layer = prv_create_layer();
+  // A parent scrolled by 10, the way a ScrollLayer moves its content
+  Layer *parent = layer_create(GRect(0, 0, FAKE_PEBBLE_SCREEN_WIDTH, FAKE_PEBBLE_SCREEN_HEIGHT));
+  layer_set_bounds(parent, GRect(0, 10, FAKE_PEBBLE_SCREEN_WIDTH, FAKE_PEBBLE_SCREEN_HEIGHT));
+  layer_add_child(parent, layer);
+  SelectionLayerData *data = layer_get_data(layer);
+  FakeFont font = {.line_height = 40, .glyph_top = 13, .glyph_width = 20, .glyph_height = 22};
+
+  selection_layer_set_font(layer, &font);
+  fake_pebble_render(parent);
+  assert(data->font_height == font.glyph_height);
+  assert(data->font_top_padding == font.glyph_top);
+
+  layer_remove_from_parent(layer);
+  layer_destroy(parent);
+  selection_layer_destroy(layer);
+}
+
+static void test_font_off_screen_falls_back_to_line_height(void) {
+  Layer *layer = prv_create_layer();
+  SelectionLayerData *data = layer_get_data(layer);
+  FakeFont font = {.line_height = 40, .glyph_top = 13, .glyph_width = 20, .glyph_height = 22};
+
+  // Above the top of the screen, where the corner can't be measured
+  layer_set_frame(layer, GRect(0, -30, FAKE_PEBBLE_SCREEN_WIDTH, 40));
+  selection_layer_set_font(layer, &font);
+  fake_pebble_render(layer);
+  assert(data->font_metrics_are_valid);
+  assert(data->font_height == font.line_height);
+  assert(data->font_top_padding == 0);
+
+  // Measured once, not on every frame after
+  const uint32_t capture_count = fake_pebble_get_counters()->frame_buffer_capture_count;
+  fake_pebble_click(BUTTON_ID_UP);
+  prv_run_frames(layer, SETTLE_MS);
+  assert(fake_pebble_get_counters()->frame_buffer_capture_count == capture_count);
+
+  selection_layer_destroy(layer);
+}
+
+static void test_low_power_skips_settles_and_frames(void) {
+  Layer *layer = prv_create_layer();
+  power_policy_init();
+  fake_pebble_set_battery_state((BatteryChargeState) {.charge_percent = 10});
+  assert(power_policy_is_low_power());
+
+  const uint32_t wakeup_count = frame_scheduler_get_wakeup_count();
+  fake_pebble_click(BUTTON_ID_UP);
+  // The bump takes 107 ms and its settle is skipped, ticking every other frame
+  prv_run_frames(layer, 300);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+  assert(s_values[0] == 1);
+  assert(frame_scheduler_get_wakeup_count() - wakeup_count <= 300 / (2 * FRAME_SCHEDULER_FRAME_MS) + 1);
+  // Low power is the policy's business, the watchdog only reports drawing time
+  assert(selection_layer_get_animation_level(layer) == FrameWatchdogLevelFull);
+
+  power_policy_deinit();
+  selection_layer_destroy(layer);
+}
+
+static void prv_noop_callback(void *context) {
+}
+
+static void test_full_scheduler_lands_presses_at_once(void) {
+  Layer *layer = prv_create_layer();
+  static int s_contexts[FRAME_SCHEDULER_MAX_SLOTS];
+  for (int i = 0; i < FRAME_SCHEDULER_MAX_SLOTS; i++) {
+    frame_scheduler_schedule(prv_noop_callback, &s_contexts[i], SETTLE_MS);
+  }
+
+  // With no slot for the engine the press is applied straight away instead of stalling mid-bump
+  fake_pebble_click(BUTTON_ID_UP);
+  assert(s_values[0] == 1);
+  fake_pebble_click(BUTTON_ID_SELECT);
+  fake_pebble_render(layer);
+  assert(gcolor_equal(prv_get_cell_color(layer, 1), GColorWhite));
+
+  for (int i = 0; i < FRAME_SCHEDULER_MAX_SLOTS; i++) {
+    frame_scheduler_cancel(prv_noop_callback, &s_contexts[i]);
+  }
+  selection_layer_destroy(layer);
+}
+
+static void test_destroy_stops_the_engine(void) {
+  Layer *layer = prv_create_layer();
+
+  fake_pebble_click(BUTTON_ID_UP);
+  prv_run_frames(layer, FRAME_SCHEDULER_FRAME_MS);
+  assert(fake_pebble_get_pending_timer_count() == 1);
+
+  selection_layer_destroy(layer);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+}
+
+int main(void) {
+  test_presses_allocate_no_animations();
+  test_cells_are_drawn_in_their_state();
+  test_row_change_stays_in_the_rows();
+  test_other_fonts_are_measured_from_their_glyphs();
+  test_font_measured_through_scrolled_parent();
+  test_font_off_screen_falls_back_to_line_height();
+  test_low_power_skips_settles_and_frames();
+  test_full_scheduler_lands_presses_at_once();
+  test_destroy_stops_the_engine();
+  printf("test_selection_layer: passed\n");
+  return 0;
+}
@@ -0,0 +1,108 @@
+// Host test for the fixed point animation math in src/layers/selection_layer.c. It compares every
+// millisecond of every phase against the integer percent math the layer used before, and against
+// the exact value. See run_tests.sh
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "fake_pebble.h"
+// Included rather than linked so the test can reach the static helpers and tables
+#include "layers/selection_layer.c"
+
+// Distances the layer scales by progress: the text bump, the settle, cell padding and slides
+static const int s_values[] = { 1, 6, 10, -10, 28, 46, -46, 90 };
+#define NUM_VALUES ((int)(sizeof(s_values) / sizeof(s_values[0])))
+
+static const EasingCurve s_curves[] = { EasingCurveEaseIn, EasingCurveEaseOut };
+#define NUM_CURVES ((int)(sizeof(s_curves) / sizeof(s_curves[0])))
+
+// What the layer did before: elapsed time to progress, progress to percent, percent to pixels,
+// each with a division
+static int prv_old_pixels(int value, uint32_t elapsed_ms, uint32_t duration_ms, EasingCurve curve) {
+  const AnimationProgress progress = (elapsed_ms * ANIMATION_NORMALIZED_MAX) / duration_ms;
+  const int percent = (100 * easing_apply(curve, progress)) / ANIMATION_NORMALIZED_MAX;
+  return (value * percent) / 100;
+}
+
+// What the layer does now, using its own rate table and scaling
+static int prv_new_pixels(int value, uint32_t elapsed_ms, SelectionLayerAnimationPhase phase,
+                          EasingCurve curve) {
+  const AnimationProgress progress = (elapsed_ms * s_phase_rates[phase]) >> PHASE_RATE_SHIFT;
+  return prv_scale_by_progress(value, easing_apply(curve, progress));
+}
+
+static double prv_exact_pixels(int value, uint32_t elapsed_ms, uint32_t duration_ms, EasingCurve curve) {
+  const AnimationProgress progress = lround(((double)elapsed_ms * ANIMATION_NORMALIZED_MAX) / duration_ms);
+  return ((double)value * easing_apply(curve, progress)) / ANIMATION_NORMALIZED_MAX;
+}
+
+static void test_fixed_point_frames_are_as_close_or_closer(void) {
+  double old_total_error = 0;
+  double new_total_error = 0;
+  double new_max_error = 0;
+  uint32_t frame_count = 0;
+
+  for (SelectionLayerAnimationPhase phase = SelectionLayerAnimationPhaseBumpText;
+       phase <= SelectionLayerAnimationPhaseSlideSettle; phase++) {
+    const uint32_t duration_ms = s_phase_durations_ms[phase];
+    for (int c = 0; c < NUM_CURVES; c++) {
+      for (int v = 0; v < NUM_VALUES; v++) {
+        const int value = s_values[v];
+        int last_new = 0;
+        for (uint32_t elapsed_ms = 0; elapsed_ms < duration_ms; elapsed_ms++) {
+          const double exact = prv_exact_pixels(value, elapsed_ms, duration_ms, s_curves[c]);
+          const int old_px = prv_old_pixels(value, elapsed_ms, duration_ms, s_curves[c]);
+          const int new_px = prv_new_pixels(value, elapsed_ms, phase, s_curves[c]);
+
+          const double old_error = fabs(old_px - exact);
+          const double new_error = fabs(new_px - exact);
+          // Rounding to the nearest pixel is never further out than truncating twice
+          assert(new_error <= old_error + 0.5);
+          old_total_error += old_error;
+          new_total_error += new_error;
+          if (new_error > new_max_error) {
+            new_max_error = new_error;
+          }
+
+          // The curves only move one way, so neither may the frames
+          if (elapsed_ms > 0) {
+            assert((value > 0) ? (new_px >= last_new) : (new_px <= last_new));
+          }
+          last_new = new_px;
+          frame_count++;
+        }
+
+        // The first frame is unchanged and the last one lands on the end value
+        assert(prv_new_pixels(value, 0, phase, s_curves[c]) == 0);
+        assert(prv_scale_by_progress(value, ANIMATION_NORMALIZED_MAX) == value);
+      }
+    }
+  }
+
+  assert(new_max_error <= 0.51);
+  assert(new_total_error <= old_total_error);
+  printf("test_selection_layer_math: %u frames, mean error %.3f px (was %.3f px)\n", frame_count,
+         new_total_error / frame_count, old_total_error / frame_count);
+}
+
+// Each phase rate is a compile time constant, so the runtime path is a multiply and a shift. Make
+// sure it still tracks elapsed / duration to within a unit of progress
+static void test_phase_rates_track_the_division(void) {
+  for (SelectionLayerAnimationPhase phase = SelectionLayerAnimationPhaseBumpText;
+       phase <= SelectionLayerAnimationPhaseSlideSettle; phase++) {
+    const uint32_t duration_ms = s_phase_durations_ms[phase];
+    for (uint32_t elapsed_ms = 0; elapsed_ms < duration_ms; elapsed_ms++) {
+      const int32_t divided = (elapsed_ms * ANIMATION_NORMALIZED_MAX) / duration_ms;
+      const int32_t shifted = (elapsed_ms * s_phase_rates[phase]) >> PHASE_RATE_SHIFT;
+      assert(shifted <= divided && divided - shifted <= 1);
+    }
+  }
+}
+
+int main(void) {
+  test_phase_rates_track_the_division();
+  test_fixed_point_frames_are_as_close_or_closer();
+  printf("test_selection_layer_math: passed\n");
+  return 0;
+}
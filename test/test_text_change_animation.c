@@ -0,0 +1,64 @@
+// Host test for src/modules/text_change_animation.c against the fake SDK. See run_tests.sh
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "fake_pebble.h"
+#include "modules/text_change_animation.h"
+
+#define DISTANCE 5
+#define HALF_DURATION_MS 40
+#define NUM_RUNS 10
+
+static int s_swap_count;
+
+static void prv_swap_handler(TextChangeAnimation *animation, void *context) {
+  s_swap_count++;
+}
+
+static void test_text_changes_allocate_nothing(void) {
+  fake_pebble_reset();
+  s_swap_count = 0;
+  const GRect rest_frame = GRect(6, 60, 132, 60);
+  Layer *layer = layer_create(rest_frame);
+  TextChangeAnimation *animation = text_change_animation_create(layer, rest_frame, DISTANCE,
+                                                                HALF_DURATION_MS);
+  text_change_animation_set_swap_handler(animation, prv_swap_handler, NULL);
+
+  // The component itself is the only allocation
+  FakePebbleCounters *counters = fake_pebble_get_counters();
+  assert(counters->malloc_count == 1);
+
+  for (int i = 0; i < NUM_RUNS; i++) {
+    text_change_animation_start(animation);
+    assert(text_change_animation_is_running(animation));
+    // Out of the rest frame on the way out, but never further than the distance
+    fake_pebble_advance_ms(HALF_DURATION_MS - 1);
+    const GRect frame = layer_get_frame(layer);
+    assert(frame.origin.x < rest_frame.origin.x && frame.origin.x >= rest_frame.origin.x - DISTANCE);
+
+    fake_pebble_advance_ms(4 * HALF_DURATION_MS);
+    assert(!text_change_animation_is_running(animation));
+    const GRect end_frame = layer_get_frame(layer);
+    assert(grect_equal(&end_frame, &rest_frame));
+    assert(s_swap_count == i + 1);
+  }
+
+  // A run cut short still swaps the text, and allocates nothing either
+  text_change_animation_start(animation);
+  text_change_animation_finish(animation);
+  assert(s_swap_count == NUM_RUNS + 1);
+
+  assert(counters->malloc_count == 1);
+  assert(counters->animation_create_count == 0);
+  assert(fake_pebble_get_pending_timer_count() == 0);
+
+  text_change_animation_destroy(animation);
+  layer_destroy(layer);
+}
+
+int main(void) {
+  test_text_changes_allocate_nothing();
+  printf("test_text_change_animation: passed\n");
+  return 0;
+}